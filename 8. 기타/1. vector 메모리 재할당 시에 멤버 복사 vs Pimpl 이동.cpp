@@ -5,6 +5,13 @@
 #include <vector>
 #include <memory>
 #include <chrono>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
 
 using namespace std;
 using namespace std::chrono;
@@ -102,8 +109,313 @@ public:
 
 };
 
+/*
+ * 전역 operator new/delete 교체로 힙 할당 추적
+ *
+ * -DTRACK_ALLOC 으로 빌드할 때만 켜진다.
+ *
+ * 각 측정 구간마다 할당 횟수, 해제 횟수, 할당 바이트,
+ * 구간 시작 대비 살아 있는 바이트와 최대 바이트를 센다.
+ *
+ * - name 문자열(SSO 15바이트를 넘는다)과 make_unique<WidgetImpl>,
+ *   vector 버퍼 재할당이 모두 잡힌다.
+ * - 해제 시 크기를 알아야 하므로 블록 앞에 크기를 기록해 둔다.
+ * - 벤치마크는 단일 스레드이므로 카운터는 atomic 이 아니다.
+ */
+struct AllocStats
+{
+    size_t allocs = 0, frees = 0, bytes = 0, live = 0, peak = 0;
+};
+
+#ifdef TRACK_ALLOC
+constexpr bool kTrackAlloc = true;
+#else
+constexpr bool kTrackAlloc = false;
+#endif
+
+AllocStats g_alloc;
+
+#ifdef TRACK_ALLOC
+constexpr size_t kAllocHeader = alignof(max_align_t);
+
+void* operator new(size_t size)
+{
+    char* raw = static_cast<char*>(malloc(size + kAllocHeader));
+
+    if (raw == nullptr)
+        throw bad_alloc();
+
+    *reinterpret_cast<size_t*>(raw) = size;
+
+    ++g_alloc.allocs;
+    g_alloc.bytes += size;
+    g_alloc.live += size;
+    g_alloc.peak = max(g_alloc.peak, g_alloc.live);
+
+    return raw + kAllocHeader;
+}
+
+void operator delete(void* p) noexcept
+{
+    if (p == nullptr)
+        return;
+
+    char* raw = static_cast<char*>(p) - kAllocHeader;
+
+    ++g_alloc.frees;
+    g_alloc.live -= *reinterpret_cast<size_t*>(raw);
+
+    free(raw);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    operator delete(p);
+}
+#endif
+
+/* 구간 시작: 누적 카운터를 비우고, 지금 살아 있는 바이트를 기준점으로 삼는다. */
+size_t alloc_phase_begin()
+{
+    g_alloc.allocs = g_alloc.frees = g_alloc.bytes = 0;
+    g_alloc.peak = g_alloc.live;
+
+    return g_alloc.live;
+}
+
+/* 구간 끝: live, peak 는 기준점 대비 증가량으로 돌려준다. */
+AllocStats alloc_phase_end(size_t base)
+{
+    AllocStats s = g_alloc;
+    s.live -= base;
+    s.peak -= base;
+
+    return s;
+}
+
+/*
+ * 벤치마크 하네스
+ *
+ * system_clock 으로 한 번만 재면
+ * 실행할 때마다의 오차가 두 버전의 차이보다 커질 수 있다.
+ *
+ * - steady_clock 으로 측정한다. (시스템 시각 조정의 영향을 받지 않는다.)
+ * - 워밍업 실행은 버리고, N 번 반복 측정한다.
+ * - 평균 대신 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ * - CSV/JSON 으로 출력해 빌드 간에 비교할 수 있다.
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 크기 증가로 메모리 재할당 시에 데이터 멤버를 직접 복사하는 버전 */
+double bench_vw(int n, AllocStats& alloc)
+{
+    vector<WidgetImpl> vw;
+
+    size_t base = alloc_phase_begin();
+    steady_clock::time_point start = steady_clock::now();
+
+    for (int i = 0; i < n; ++i)
+        vw.push_back(WidgetImpl(i));
+
+    steady_clock::time_point end = steady_clock::now();
+    alloc = alloc_phase_end(base);
+
+    return duration<double>(end - start).count();
+}
+
+/* 크기 증가로 메모리 재할당 시에 Pimpl 포인터만 이동하는 버전 */
+double bench_vpimpl(int n, AllocStats& alloc)
+{
+    vector<Widget> vpimpl;
+
+    size_t base = alloc_phase_begin();
+    steady_clock::time_point start = steady_clock::now();
+
+    for (int i = 0; i < n; ++i)
+        vpimpl.push_back(Widget(i));
+
+    steady_clock::time_point end = steady_clock::now();
+    alloc = alloc_phase_end(base);
+
+    return duration<double>(end - start).count();
+}
+
+struct Options
+{
+    int n = 3000000;
+    int warmup = 1;
+    int reps = 5;
+    string variant = "all";
+    string format = "text";
+};
+
+void usage(const char* prog)
+{
+    cerr << "사용법: " << prog << " [-n 원소 수] [-w 워밍업 횟수] [-r 반복 횟수]"
+         << " [-v all|vw|vpimpl] [-f text|csv|json]" << endl;
+}
+
+bool parse_options(int argc, char* argv[], Options& opt)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (i + 1 >= argc)
+            return false;
+
+        const char* key = argv[i];
+        const char* value = argv[++i];
+
+        if (strcmp(key, "-n") == 0)
+            opt.n = atoi(value);
+        else if (strcmp(key, "-w") == 0)
+            opt.warmup = atoi(value);
+        else if (strcmp(key, "-r") == 0)
+            opt.reps = atoi(value);
+        else if (strcmp(key, "-v") == 0)
+            opt.variant = value;
+        else if (strcmp(key, "-f") == 0)
+            opt.format = value;
+        else
+            return false;
+    }
+
+    if (opt.n < 0 || opt.warmup < 0 || opt.reps < 1)
+        return false;
+
+    if (opt.variant != "all" && opt.variant != "vw" && opt.variant != "vpimpl")
+        return false;
+
+    return opt.format == "text" || opt.format == "csv" || opt.format == "json";
+}
+
+struct Result
+{
+    string variant;
+    Stats stats;
+    AllocStats alloc;   // 마지막 반복의 측정 구간
+};
+
+void report(const Options& opt, const vector<Result>& results)
+{
+    if (opt.format == "csv")
+    {
+        cout << "variant,n,reps,median,p95,mad,min,max";
+        if (kTrackAlloc)
+            cout << ",allocs,frees,bytes,live_bytes,peak_bytes";
+        cout << endl;
+
+        for (const Result& r : results)
+        {
+            cout << r.variant << ',' << opt.n << ',' << opt.reps << ','
+                 << r.stats.median << ',' << r.stats.p95 << ',' << r.stats.mad << ','
+                 << r.stats.min << ',' << r.stats.max;
+            if (kTrackAlloc)
+                cout << ',' << r.alloc.allocs << ',' << r.alloc.frees << ',' << r.alloc.bytes
+                     << ',' << r.alloc.live << ',' << r.alloc.peak;
+            cout << endl;
+        }
+    }
+    else if (opt.format == "json")
+    {
+        cout << "[" << endl;
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& r = results[i];
+
+            cout << "  {\"variant\": \"" << r.variant << "\", \"n\": " << opt.n
+                 << ", \"reps\": " << opt.reps
+                 << ", \"median\": " << r.stats.median << ", \"p95\": " << r.stats.p95
+                 << ", \"mad\": " << r.stats.mad << ", \"min\": " << r.stats.min
+                 << ", \"max\": " << r.stats.max;
+            if (kTrackAlloc)
+                cout << ", \"allocs\": " << r.alloc.allocs << ", \"frees\": " << r.alloc.frees
+                     << ", \"bytes\": " << r.alloc.bytes << ", \"live_bytes\": " << r.alloc.live
+                     << ", \"peak_bytes\": " << r.alloc.peak;
+            cout << "}" << (i + 1 < results.size() ? "," : "") << endl;
+        }
+
+        cout << "]" << endl;
+    }
+    else
+    {
+        for (const Result& r : results)
+        {
+            cout << r.variant << ": 중앙값 " << r.stats.median << " 초"
+                 << ", p95 " << r.stats.p95 << " 초"
+                 << ", MAD " << r.stats.mad << " 초" << endl;
+            if (kTrackAlloc)
+                cout << "    할당 " << r.alloc.allocs << " 회, 해제 " << r.alloc.frees << " 회"
+                     << ", " << r.alloc.bytes << " 바이트"
+                     << ", 남은 " << r.alloc.live << " 바이트"
+                     << ", 최대 " << r.alloc.peak << " 바이트" << endl;
+        }
+    }
+}
+
 int main(int argc, char* argv[])
 {
+    Options opt;
+
+    if (!parse_options(argc, argv, opt))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
     vector<WidgetImpl> vw;
     vector<Widget> vpimpl;
 
@@ -127,10 +439,11 @@ int main(int argc, char* argv[])
     vpimpl[0] = vpimpl[1];
     //cout << endl;
 
-    system_clock::time_point start, end;
     vw.clear();
     vpimpl.clear();
-    
+
+    vector<Result> results;
+
     /*
      * 크기 증가로 메모리 재할당 시에
      * 데이터 멤버를 직접 복사하는 버전
@@ -143,14 +456,11 @@ int main(int argc, char* argv[])
      * 메모리 재할당이 일어날 때마다
      * 메모리 사용량이 들쑥날쑥 해진다.
      */
+    if (opt.variant == "all" || opt.variant == "vw")
     {
-        start = system_clock::now();
-
-        for (int i = 0; i < 3000000; ++i)
-            vw.push_back(WidgetImpl(i));
-
-        end = system_clock::now();
-        cout << duration<double>(end - start).count() << " 초" << endl;
+        AllocStats alloc;
+        Stats stats = summarize(run_bench([&] { return bench_vw(opt.n, alloc); }, opt.warmup, opt.reps));
+        results.push_back({"vw", stats, alloc});
     }
 
     /*
@@ -164,15 +474,14 @@ int main(int argc, char* argv[])
      *
      * 메모리 사용량이 선형적으로 증가한다.
      */
+    if (opt.variant == "all" || opt.variant == "vpimpl")
     {
-        start = system_clock::now();
-
-        for (int i = 0; i < 3000000; ++i)
-            vpimpl.push_back(Widget(i));
-
-        end = system_clock::now();
-        cout << duration<double>(end - start).count() << " 초" << endl;
+        AllocStats alloc;
+        Stats stats = summarize(run_bench([&] { return bench_vpimpl(opt.n, alloc); }, opt.warmup, opt.reps));
+        results.push_back({"vpimpl", stats, alloc});
     }
 
+    report(opt, results);
+
     return 0;
 }
@@ -0,0 +1,312 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 변형마다 프로세스를 분리해 실행하고 최대 RSS 측정
+ *
+ * 한 프로세스에서 vw 다음에 vpimpl 을 실행하면
+ * - 두 번째 측정은 첫 번째가 남긴 단편화된 힙과 페이지 상태를 물려받는다.
+ * - 최대 RSS 는 프로세스 전체의 값이라 어느 쪽 몫인지 알 수 없다.
+ *
+ * 변형마다 fork 로 자식 프로세스를 만들어 깨끗한 힙에서 실행하고
+ * 자식은 getrusage 로 얻은 값을 파이프로 부모에게 보낸다.
+ * - 경과 시간
+ * - ru_maxrss: 최대 RSS (리눅스에서는 KiB)
+ * - ru_minflt / ru_majflt: 소/대 페이지 폴트
+ * - ru_nvcsw / ru_nivcsw: 자발적/비자발적 문맥 교환
+ *
+ * 부모는 반복 실행 결과를 모아 중앙값을 출력한다.
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+    friend class Widget;
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    WidgetImpl(const WidgetImpl& rhs)
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name)
+    {
+
+    }
+
+    /* noexcept 이 아니기 때문에 메모리 재할당 시에는 복사 생성이 사용된다. */
+    WidgetImpl(WidgetImpl&& rhs)
+        : i(move(rhs.i)), b(move(rhs.b)), c(move(rhs.c)), d(move(rhs.d)), name(move(rhs.name))
+    {
+
+    }
+};
+
+class Widget
+{
+    unique_ptr<WidgetImpl> pimpl;
+
+public:
+    Widget(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : pimpl(make_unique<WidgetImpl>(i, b, c, d, name))
+    {
+
+    }
+
+    /* vector 는 메모리 재할당 시에
+     * 이동 생성자가 noexcept 인 경우에만 복사 대신 이동을 한다. */
+    Widget(Widget&& rhs) : pimpl(move(rhs.pimpl))
+    {
+
+    }
+};
+
+/* 자식이 파이프로 보내는 결과: 트리비얼한 타입이므로 그대로 write/read 한다. */
+struct ChildResult
+{
+    double seconds;
+    long maxrss_kb;
+    long minflt, majflt;
+    long nvcsw, nivcsw;
+};
+
+template <typename T>
+double run_loop(int n)
+{
+    vector<T> v;
+
+    steady_clock::time_point start = steady_clock::now();
+
+    for (int i = 0; i < n; ++i)
+        v.push_back(T(i));
+
+    steady_clock::time_point end = steady_clock::now();
+
+    return duration<double>(end - start).count();
+}
+
+/* 자식 프로세스에서 body 를 실행하고 결과를 받아 온다.
+ * 실패하면 false 를 돌려주고 error 에 이유를 남긴다.
+ * errno 는 pipe, fork, waitpid 실패일 때만 의미가 있고, 자식의 실패는 종료 상태로 알린다. */
+template <typename Body>
+bool run_isolated(Body body, ChildResult& result, string& error)
+{
+    int fds[2];
+
+    if (pipe(fds) != 0)
+    {
+        error = string("pipe: ") + strerror(errno);
+        return false;
+    }
+
+    pid_t pid = fork();
+
+    if (pid < 0)
+    {
+        error = string("fork: ") + strerror(errno);
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if (pid == 0)
+    {
+        close(fds[0]);
+
+        ChildResult r{};
+        r.seconds = body();
+
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        r.maxrss_kb = usage.ru_maxrss;
+        r.minflt = usage.ru_minflt;
+        r.majflt = usage.ru_majflt;
+        r.nvcsw = usage.ru_nvcsw;
+        r.nivcsw = usage.ru_nivcsw;
+
+        ssize_t written = write(fds[1], &r, sizeof(r));
+
+        /* 소멸자와 atexit 처리기를 건너뛰고 바로 종료한다. */
+        _exit(written == static_cast<ssize_t>(sizeof(r)) ? 0 : 1);
+    }
+
+    close(fds[1]);
+
+    ssize_t got = 0;
+
+    while (got < static_cast<ssize_t>(sizeof(result)))
+    {
+        ssize_t k = read(fds[0], reinterpret_cast<char*>(&result) + got, sizeof(result) - got);
+
+        if (k <= 0)
+            break;
+
+        got += k;
+    }
+
+    close(fds[0]);
+
+    int status = 0;
+
+    if (waitpid(pid, &status, 0) < 0)
+    {
+        error = string("waitpid: ") + strerror(errno);
+        return false;
+    }
+
+    if (WIFSIGNALED(status))
+    {
+        error = "시그널 " + to_string(WTERMSIG(status)) + " 로 종료";
+        return false;
+    }
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        error = "종료 코드 " + to_string(WEXITSTATUS(status));
+        return false;
+    }
+
+    if (got != static_cast<ssize_t>(sizeof(result)))
+    {
+        error = "결과를 " + to_string(got) + " / " + to_string(sizeof(result)) + " 바이트만 받았다";
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ * - 자식마다 새 프로세스에서 시작하는 것이 목적이므로 워밍업 실행은 두지 않는다.
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+template <typename Field>
+double median_field(const vector<ChildResult>& results, Field field)
+{
+    vector<double> values;
+
+    for (const ChildResult& r : results)
+        values.push_back(static_cast<double>(r.*field));
+
+    return summarize(values).median;
+}
+
+void print_row(const char* name, const vector<ChildResult>& results)
+{
+    cout << left << setw(10) << name << right
+         << setw(12) << median_field(results, &ChildResult::seconds)
+         << setw(14) << median_field(results, &ChildResult::maxrss_kb)
+         << setw(12) << median_field(results, &ChildResult::minflt)
+         << setw(10) << median_field(results, &ChildResult::majflt)
+         << setw(10) << median_field(results, &ChildResult::nvcsw)
+         << setw(10) << median_field(results, &ChildResult::nivcsw) << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 3;
+
+    if (reps < 1)
+    {
+        cerr << "반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    vector<ChildResult> vw_results, vpimpl_results;
+
+    for (int r = 0; r < reps; ++r)
+    {
+        ChildResult result;
+        string error;
+
+        /* 데이터 멤버를 직접 복사하는 버전 */
+        if (!run_isolated([&] { return run_loop<WidgetImpl>(n); }, result, error))
+        {
+            cerr << "vw 자식 프로세스 실패: " << error << endl;
+            return 1;
+        }
+        vw_results.push_back(result);
+
+        /* Pimpl 포인터만 이동하는 버전 */
+        if (!run_isolated([&] { return run_loop<Widget>(n); }, result, error))
+        {
+            cerr << "vpimpl 자식 프로세스 실패: " << error << endl;
+            return 1;
+        }
+        vpimpl_results.push_back(result);
+    }
+
+    cout << left << setw(10) << "variant" << right
+         << setw(12) << "seconds"
+         << setw(14) << "maxrss KiB"
+         << setw(12) << "minflt"
+         << setw(10) << "majflt"
+         << setw(10) << "nvcsw"
+         << setw(10) << "nivcsw" << endl;
+
+    print_row("vw", vw_results);
+    print_row("vpimpl", vpimpl_results);
+
+    return 0;
+}
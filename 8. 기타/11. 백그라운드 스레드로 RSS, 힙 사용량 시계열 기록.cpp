@@ -0,0 +1,279 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 백그라운드 스레드로 RSS, 힙 사용량 시계열 기록
+ *
+ * (빌드: g++ -O2 -pthread)
+ *
+ * vector<WidgetImpl> 는 재할당할 때마다 잠깐 원본과 새 버퍼를 함께 들고 있어서
+ * 메모리 사용량이 들쑥날쑥 해지고,
+ * vector<Widget> 은 포인터 배열만 재할당하므로 선형적으로 증가한다고 했다.
+ *
+ * 샘플러 스레드가 수백 마이크로초마다
+ * - /proc/self/statm 의 RSS
+ * - mallinfo2() 의 힙 사용량 (uordblks: 사용 중, hblkhd: mmap 으로 할당된 큰 블록)
+ * 을 읽어 시계열로 남긴다. (힙은 측정 시작 시점 대비 증가량)
+ *
+ * 측정 스레드는 용량이 바뀐 시각을 따로 기록하고,
+ * 끝나면 둘을 합쳐 CSV 로 출력한다.
+ *
+ * mallinfo2() 는 할당자 잠금을 잡으므로 측정 대상을 조금 느리게 만든다.
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+    friend class Widget;
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    WidgetImpl(const WidgetImpl& rhs)
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name)
+    {
+
+    }
+
+    /* noexcept 이 아니기 때문에 메모리 재할당 시에는 복사 생성이 사용된다. */
+    WidgetImpl(WidgetImpl&& rhs)
+        : i(move(rhs.i)), b(move(rhs.b)), c(move(rhs.c)), d(move(rhs.d)), name(move(rhs.name))
+    {
+
+    }
+};
+
+class Widget
+{
+    unique_ptr<WidgetImpl> pimpl;
+
+public:
+    Widget(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : pimpl(make_unique<WidgetImpl>(i, b, c, d, name))
+    {
+
+    }
+
+    /* vector 는 메모리 재할당 시에
+     * 이동 생성자가 noexcept 인 경우에만 복사 대신 이동을 한다. */
+    Widget(Widget&& rhs) : pimpl(move(rhs.pimpl))
+    {
+
+    }
+};
+
+struct Sample
+{
+    double t_ms;
+    long rss_kb;
+    long long heap_bytes;   // 측정 시작 시점 대비
+};
+
+struct CapacityEvent
+{
+    double t_ms;
+    size_t capacity;
+};
+
+size_t heap_in_use()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 mi = mallinfo2();
+#else
+    struct mallinfo mi = mallinfo();
+#endif
+
+    return static_cast<size_t>(mi.uordblks) + static_cast<size_t>(mi.hblkhd);
+}
+
+class MemorySampler
+{
+    steady_clock::time_point origin;
+    microseconds interval;
+
+    vector<Sample> samples;
+    atomic<bool> running{false};
+    thread worker;
+
+    int statm_fd = -1;
+    long page_kb = 4;
+    size_t heap_base = 0;
+
+    long read_rss_kb() const
+    {
+        char buf[128];
+        ssize_t len = pread(statm_fd, buf, sizeof(buf) - 1, 0);
+
+        if (len <= 0)
+            return -1;
+
+        buf[len] = '\0';
+
+        long size_pages = 0, resident_pages = 0;
+        sscanf(buf, "%ld %ld", &size_pages, &resident_pages);
+
+        return resident_pages * page_kb;
+    }
+
+    void loop()
+    {
+        while (running.load(memory_order_relaxed))
+        {
+            double t = duration<double, milli>(steady_clock::now() - origin).count();
+            long long heap = static_cast<long long>(heap_in_use()) - static_cast<long long>(heap_base);
+            samples.push_back(Sample{t, read_rss_kb(), heap});
+
+            this_thread::sleep_for(interval);
+        }
+    }
+
+public:
+    MemorySampler(steady_clock::time_point origin, microseconds interval)
+    : origin(origin), interval(interval)
+    {
+        statm_fd = open("/proc/self/statm", O_RDONLY);
+        page_kb = sysconf(_SC_PAGESIZE) / 1024;
+
+        /* 샘플러 자신의 재할당이 측정을 흐리지 않도록 미리 잡아 둔다. */
+        samples.reserve(1 << 20);
+    }
+
+    MemorySampler(const MemorySampler&) = delete;
+    MemorySampler& operator= (const MemorySampler&) = delete;
+
+    ~MemorySampler()
+    {
+        stop();
+
+        if (statm_fd >= 0)
+            close(statm_fd);
+    }
+
+    void start()
+    {
+        /* 샘플 버퍼 자체도 힙에 있으므로 시작 시점의 힙 사용량을 기준으로 삼는다. */
+        heap_base = heap_in_use();
+        running = true;
+        worker = thread(&MemorySampler::loop, this);
+    }
+
+    void stop()
+    {
+        running = false;
+
+        if (worker.joinable())
+            worker.join();
+    }
+
+    const vector<Sample>& result() const { return samples; }
+};
+
+/* 측정 중에 용량이 바뀐 시각을 기록하며 n 개를 push_back 한다. */
+template <typename T>
+void run_loop(int n, steady_clock::time_point origin, vector<CapacityEvent>& events)
+{
+    vector<T> v;
+
+    for (int i = 0; i < n; ++i)
+    {
+        size_t cap = v.capacity();
+
+        v.push_back(T(i));
+
+        if (v.capacity() != cap)
+            events.push_back(CapacityEvent{duration<double, milli>(steady_clock::now() - origin).count(), v.capacity()});
+    }
+}
+
+/* 샘플과 용량 변경 이벤트를 시간 순으로 합쳐 CSV 로 쓴다. */
+void write_timeline(ostream& out, const char* variant, const vector<Sample>& samples, const vector<CapacityEvent>& events)
+{
+    size_t e = 0;
+
+    for (const Sample& s : samples)
+    {
+        for (; e < events.size() && events[e].t_ms <= s.t_ms; ++e)
+            out << variant << ',' << events[e].t_ms << ",,," << events[e].capacity << '\n';
+
+        out << variant << ',' << s.t_ms << ',' << s.rss_kb << ',' << s.heap_bytes << ",\n";
+    }
+
+    for (; e < events.size(); ++e)
+        out << variant << ',' << events[e].t_ms << ",,," << events[e].capacity << '\n';
+}
+
+template <typename T>
+void record(const char* variant, int n, microseconds interval, ostream& out)
+{
+    steady_clock::time_point origin = steady_clock::now();
+    vector<CapacityEvent> events;
+    events.reserve(64);
+
+    MemorySampler sampler(origin, interval);
+    sampler.start();
+
+    run_loop<T>(n, origin, events);
+
+    sampler.stop();
+
+    write_timeline(out, variant, sampler.result(), events);
+
+    cout << variant << ": 샘플 " << sampler.result().size() << " 개, 재할당 " << events.size() << " 회" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    const char* path = argc > 2 ? argv[2] : "timeline.csv";
+    microseconds interval(argc > 3 ? atoi(argv[3]) : 250);
+
+    /* 간격이 0 이하면 샘플러가 쉬지 않고 돌아 미리 잡아 둔 버퍼를 넘어선다. */
+    if (n < 0 || interval < microseconds(1))
+    {
+        cerr << "원소 수는 0 이상, 샘플 간격은 1 마이크로초 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    ofstream out(path);
+
+    if (!out)
+    {
+        cerr << path << " 를 열 수 없다." << endl;
+        return 1;
+    }
+
+    /* 용량 변경 행은 rss_kb, heap_bytes 가 비어 있고, 샘플 행은 capacity 가 비어 있다. */
+    out << "variant,t_ms,rss_kb,heap_bytes,capacity\n";
+
+    /* 재할당 순간마다 일시적으로 2배가 되는 버전 */
+    record<WidgetImpl>("vw", n, interval, out);
+
+    /* 꾸준히 선형으로 증가하는 버전 */
+    record<Widget>("vpimpl", n, interval, out);
+
+    cout << path << " 에 기록했다." << endl;
+
+    return 0;
+}
@@ -0,0 +1,317 @@
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 이름 문자열 인터닝(interning)으로 name 할당 제거
+ *
+ * 기본 name "AAAAAAAAAAAAAABBBBBBBBBBB" 는 25 글자로
+ * libstdc++ 의 SSO 버퍼(15 글자)보다 길다.
+ * - 생성할 때마다 힙 할당이 한 번 일어나고
+ * - 재할당으로 복사할 때마다 또 한 번 일어난다.
+ *
+ * 같은 이름이 반복되므로 플라이웨이트 패턴을 적용한다.
+ * - NameTable 은 중복 없는 문자열 풀이고, 이름마다 32비트 번호(NameId)를 준다.
+ * - WidgetImpl 은 string 대신 NameId 만 들고, string_view 로 이름을 읽는다.
+ * - 생성은 해시 조회 한 번 (이미 있는 이름이면 할당 없음)
+ * - 복사, 재할당은 정수 복사뿐이므로 malloc 을 건드리지 않는다.
+ *
+ * 풀의 문자열은 프로그램이 끝날 때까지 해제하지 않는다.
+ */
+
+/*
+ * 전역 operator new/delete 교체로 힙 할당 횟수 추적
+ *
+ * -DTRACK_ALLOC 으로 빌드할 때만 켜진다. (1. 의 추적기와 같은 방식)
+ * 해제 시 크기를 알아야 하므로 블록 앞에 크기를 기록해 둔다.
+ * 벤치마크는 단일 스레드이므로 카운터는 atomic 이 아니다.
+ */
+struct AllocStats
+{
+    size_t allocs = 0, frees = 0, bytes = 0, live = 0, peak = 0;
+};
+
+#ifdef TRACK_ALLOC
+constexpr bool kTrackAlloc = true;
+#else
+constexpr bool kTrackAlloc = false;
+#endif
+
+AllocStats g_alloc;
+
+#ifdef TRACK_ALLOC
+constexpr size_t kAllocHeader = alignof(max_align_t);
+
+void* operator new(size_t size)
+{
+    char* raw = static_cast<char*>(malloc(size + kAllocHeader));
+
+    if (raw == nullptr)
+        throw bad_alloc();
+
+    *reinterpret_cast<size_t*>(raw) = size;
+
+    ++g_alloc.allocs;
+    g_alloc.bytes += size;
+    g_alloc.live += size;
+    g_alloc.peak = max(g_alloc.peak, g_alloc.live);
+
+    return raw + kAllocHeader;
+}
+
+/* 인라인되면 GCC 가 operator new 의 결과를 free 하는 것으로 보고
+ * -Wmismatched-new-delete 를 내므로 인라인하지 않는다. */
+__attribute__((noinline)) void operator delete(void* p) noexcept
+{
+    if (p == nullptr)
+        return;
+
+    char* raw = static_cast<char*>(p) - kAllocHeader;
+
+    ++g_alloc.frees;
+    g_alloc.live -= *reinterpret_cast<size_t*>(raw);
+
+    free(raw);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    operator delete(p);
+}
+#endif
+
+class NameTable
+{
+    /* deque 는 뒤에 추가해도 기존 원소의 주소가 바뀌지 않으므로 string_view 가 유효하다. */
+    deque<string> storage;
+    vector<string_view> by_id;
+    unordered_map<string_view, uint32_t> ids;
+
+public:
+    uint32_t intern(string_view s)
+    {
+        unordered_map<string_view, uint32_t>::iterator it = ids.find(s);
+
+        if (it != ids.end())
+            return it->second;
+
+        storage.emplace_back(s);
+        string_view stored = storage.back();
+
+        uint32_t id = static_cast<uint32_t>(by_id.size());
+        by_id.push_back(stored);
+        ids.emplace(stored, id);
+
+        return id;
+    }
+
+    string_view view(uint32_t id) const { return by_id[id]; }
+
+    size_t size() const { return by_id.size(); }
+};
+
+NameTable& name_table()
+{
+    static NameTable table;
+
+    return table;
+}
+
+class NameId
+{
+    uint32_t id;
+
+public:
+    NameId(string_view s = "AAAAAAAAAAAAAABBBBBBBBBBB") : id(name_table().intern(s)) { }
+
+    string_view view() const { return name_table().view(id); }
+
+    bool operator== (NameId rhs) const { return id == rhs.id; }
+};
+
+/* 기존 버전: string 을 직접 들고 있다. */
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    WidgetImpl(const WidgetImpl& rhs)
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name)
+    {
+
+    }
+
+    /* noexcept 이 아니기 때문에 메모리 재할당 시에는 복사 생성이 사용된다. */
+    WidgetImpl(WidgetImpl&& rhs)
+        : i(move(rhs.i)), b(move(rhs.b)), c(move(rhs.c)), d(move(rhs.d)), name(move(rhs.name))
+    {
+
+    }
+};
+
+/* 인터닝 버전: 이름은 풀의 번호만 들고 있다. */
+class InternedWidgetImpl
+{
+    int i;
+    double b, c, d;
+    NameId name;
+    double arr[10];
+
+public:
+    InternedWidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string_view name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    /* 기존 버전과 같은 조건으로 비교하기 위해 복사 생성자를 직접 정의한다. */
+    InternedWidgetImpl(const InternedWidgetImpl& rhs)
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name)
+    {
+
+    }
+
+    string_view label() const { return name.view(); }
+};
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+template <typename T>
+void run(const char* label, int n, int reps)
+{
+    size_t allocs = 0;
+
+    Stats stats = summarize(run_bench([&] {
+        vector<T> v;
+
+        g_alloc.allocs = 0;
+        steady_clock::time_point start = steady_clock::now();
+
+        for (int i = 0; i < n; ++i)
+            v.push_back(T(i));
+
+        steady_clock::time_point end = steady_clock::now();
+
+        allocs = g_alloc.allocs;
+
+        return duration<double>(end - start).count();
+    }, kWarmup, reps));
+
+    cout << label << ": " << stats.median << " 초";
+
+    if (kTrackAlloc)
+        cout << ", 힙 할당 " << allocs << " 회";
+
+    cout << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 5;
+
+    if (reps < 1)
+    {
+        cerr << "반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    InternedWidgetImpl a(1), b(2), c(3, 0.0, 0.0, 0.0, "CCC");
+    cout << "a: " << a.label() << ", b: " << b.label() << ", c: " << c.label()
+         << ", 풀 크기: " << name_table().size() << endl;
+    cout << "sizeof(WidgetImpl): " << sizeof(WidgetImpl)
+         << ", sizeof(InternedWidgetImpl): " << sizeof(InternedWidgetImpl) << endl;
+
+    /* 생성, 재할당 복사마다 name 을 힙에 할당하는 버전 */
+    run<WidgetImpl>("string name", n, reps);
+
+    /* 이름은 번호만 복사하는 버전: 힙 할당은 vector 버퍼뿐이다. */
+    run<InternedWidgetImpl>("interned name", n, reps);
+
+    return 0;
+}
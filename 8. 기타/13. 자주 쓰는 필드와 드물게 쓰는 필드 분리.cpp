@@ -0,0 +1,287 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <type_traits>
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 자주 쓰는(hot) 필드와 드물게 쓰는(cold) 필드 분리
+ *
+ * WidgetImpl 은 자주 쓰는 작은 필드(i, b, c, d)와
+ * 큰 필드(double arr[10], string name)가 섞여 있어서 144 바이트다. (64비트 libstdc++)
+ * - 재할당으로 복사할 때도
+ * - b, c, d 만 훑을 때도
+ * 쓰지 않는 바이트까지 캐시로 끌려온다.
+ *
+ * SplitWidgets 는
+ * - hot 부분(i, b, c, d: 32 바이트)을 하나의 vector 에
+ * - cold 부분(arr, name)을 같은 인덱스의 별도 vector(사이드 테이블)에 둔다.
+ *
+ * hot 은 트리비얼하게 복사 가능하므로 vector 가 재할당 시에 memmove 로 옮기고,
+ * cold 는 규칙 0 으로 만들어진 noexcept 이동으로 옮긴다.
+ *
+ * 원래 WidgetImpl 은 이동이 noexcept 가 아니라서 재할당 때마다 name 을 복사한다.
+ * 삽입 시간의 차이가 분리 덕분인지 보려면 이동/복사 차이를 빼야 하므로
+ * 이동만 noexcept 로 바꾼 NothrowWidgetImpl 도 함께 잰다.
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    WidgetImpl(const WidgetImpl& rhs)
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name)
+    {
+
+    }
+
+    /* noexcept 이 아니기 때문에 메모리 재할당 시에는 복사 생성이 사용된다. */
+    WidgetImpl(WidgetImpl&& rhs)
+        : i(move(rhs.i)), b(move(rhs.b)), c(move(rhs.c)), d(move(rhs.d)), name(move(rhs.name))
+    {
+
+    }
+
+    double sum() const { return b + c + d; }
+};
+
+/* 멤버 배치는 WidgetImpl 과 같고, 재할당 시에 복사 대신 이동된다. */
+class NothrowWidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+public:
+    NothrowWidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    NothrowWidgetImpl(NothrowWidgetImpl&& rhs) noexcept
+        : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(move(rhs.name))
+    {
+
+    }
+};
+
+struct HotWidget
+{
+    int i;
+    double b, c, d;
+};
+
+struct ColdWidget
+{
+    string name;
+    double arr[10];
+
+    /* WidgetImpl 처럼 arr 은 초기화하지 않는다. */
+    explicit ColdWidget(string name) : name(move(name)) { }
+};
+
+static_assert(is_trivially_copyable<HotWidget>::value, "hot 부분은 memmove 로 옮길 수 있어야 한다.");
+static_assert(is_nothrow_move_constructible<ColdWidget>::value, "cold 부분은 재할당 시에 이동되어야 한다.");
+
+class SplitWidgets
+{
+    vector<HotWidget> hot_part;
+    vector<ColdWidget> cold_part;
+
+public:
+    void push_back(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    {
+        /* cold 를 먼저 넣고, hot 이 실패하면 되돌려서 두 테이블의 크기를 맞춘다. */
+        cold_part.emplace_back(move(name));
+
+        try
+        {
+            hot_part.push_back(HotWidget{i, b, c, d});
+        }
+        catch (...)
+        {
+            cold_part.pop_back();
+            throw;
+        }
+    }
+
+    HotWidget& hot(size_t idx) { return hot_part[idx]; }
+    ColdWidget& cold(size_t idx) { return cold_part[idx]; }
+
+    size_t size() const { return hot_part.size(); }
+
+    /* b, c, d 만 훑는다: 원소당 32 바이트만 읽는다. */
+    double sum() const
+    {
+        double total = 0.0;
+
+        for (const HotWidget& w : hot_part)
+            total += w.b + w.c + w.d;
+
+        return total;
+    }
+};
+
+template <typename F>
+double measure(F f)
+{
+    steady_clock::time_point start = steady_clock::now();
+    f();
+    steady_clock::time_point end = steady_clock::now();
+
+    return duration<double>(end - start).count();
+}
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 5;
+    double sink = 0.0;
+
+    if (reps < 1)
+    {
+        cerr << "반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    cout << "sizeof(WidgetImpl): " << sizeof(WidgetImpl)
+         << ", sizeof(HotWidget): " << sizeof(HotWidget)
+         << ", sizeof(ColdWidget): " << sizeof(ColdWidget) << endl;
+
+    /* 데이터 멤버를 모두 한 객체에 두는 버전 */
+    double vw_build = summarize(run_bench([&] {
+        vector<WidgetImpl> vw;
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                vw.push_back(WidgetImpl(i, 1.0, 2.0, 3.0));
+        });
+    }, kWarmup, reps)).median;
+
+    vector<WidgetImpl> vw;
+    for (int i = 0; i < n; ++i)
+        vw.push_back(WidgetImpl(i, 1.0, 2.0, 3.0));
+
+    double vw_scan = summarize(run_bench([&] {
+        return measure([&] {
+            for (const WidgetImpl& w : vw)
+                sink += w.sum();
+        });
+    }, kWarmup, reps)).median;
+
+    vw.clear();
+    vw.shrink_to_fit();
+
+    /* 한 객체 그대로, 이동만 noexcept 로 바꾼 버전 */
+    double nothrow_build = summarize(run_bench([&] {
+        vector<NothrowWidgetImpl> vn;
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                vn.push_back(NothrowWidgetImpl(i, 1.0, 2.0, 3.0));
+        });
+    }, kWarmup, reps)).median;
+
+    /* hot/cold 를 나눠 두는 버전 */
+    double split_build = summarize(run_bench([&] {
+        SplitWidgets sw;
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                sw.push_back(i, 1.0, 2.0, 3.0);
+        });
+    }, kWarmup, reps)).median;
+
+    SplitWidgets sw;
+    for (int i = 0; i < n; ++i)
+        sw.push_back(i, 1.0, 2.0, 3.0);
+
+    double split_scan = summarize(run_bench([&] { return measure([&] { sink += sw.sum(); }); }, kWarmup, reps)).median;
+
+    cout << "WidgetImpl 삽입: " << vw_build << " 초, b+c+d 순회: " << vw_scan << " 초" << endl;
+    cout << "NothrowWidgetImpl 삽입: " << nothrow_build << " 초" << endl;
+    cout << "SplitWidgets 삽입: " << split_build << " 초, b+c+d 순회: " << split_scan << " 초" << endl;
+    cout << "체크섬: " << sink << endl;
+
+    return 0;
+}
@@ -0,0 +1,257 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * pmr 메모리 리소스 위에서 두 컨테이너 실행
+ *
+ * vw 와 vpimpl 의 시간 중 얼마가 복사 비용이고 얼마가 malloc 비용인지 나눠 보려고
+ * 같은 코드를 세 가지 메모리 리소스 위에서 실행한다.
+ * - new_delete_resource: 기존과 같은 전역 new/delete
+ * - monotonic_buffer_resource: 포인터만 증가시키는 아레나, 해제는 무시하고 소멸 시에 한 번에 반환
+ * - unsynchronized_pool_resource: 크기별 풀 (단일 스레드용)
+ *
+ * 리소스가 원소 안쪽까지 전파되도록
+ * - WidgetImpl 의 name 은 pmr::string 이고
+ * - Widget 의 impl 도 같은 리소스에서 할당한다.
+ * - 둘 다 allocator_type 을 두고 마지막 인자로 할당자를 받는다. (uses-allocator 생성)
+ *   그러면 pmr::vector 가 원소를 만들 때 자신의 할당자를 넘겨준다.
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    pmr::string name;
+    double arr[10];
+
+public:
+    using allocator_type = pmr::polymorphic_allocator<char>;
+
+    explicit WidgetImpl(int i = 0, allocator_type alloc = {})
+    : i(i), b(0.0), c(0.0), d(0.0), name("AAAAAAAAAAAAAABBBBBBBBBBB", alloc)
+    {
+
+    }
+
+    WidgetImpl(const WidgetImpl& rhs, allocator_type alloc = {})
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name, alloc)
+    {
+
+    }
+
+    /* noexcept 이 아니기 때문에 메모리 재할당 시에는 복사 생성이 사용된다. */
+    WidgetImpl(WidgetImpl&& rhs, allocator_type alloc = {})
+        : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(move(rhs.name), alloc)
+    {
+
+    }
+};
+
+class Widget
+{
+    /* 어느 리소스에서 할당했는지 기억했다가 그 리소스에 돌려준다. */
+    struct ResourceDeleter
+    {
+        pmr::memory_resource* resource;
+
+        void operator() (WidgetImpl* p) const
+        {
+            p->~WidgetImpl();
+            resource->deallocate(p, sizeof(WidgetImpl), alignof(WidgetImpl));
+        }
+    };
+
+    unique_ptr<WidgetImpl, ResourceDeleter> pimpl;
+
+    template <typename Arg>
+    static unique_ptr<WidgetImpl, ResourceDeleter> create(pmr::memory_resource* resource, Arg&& arg)
+    {
+        void* p = resource->allocate(sizeof(WidgetImpl), alignof(WidgetImpl));
+
+        try
+        {
+            return unique_ptr<WidgetImpl, ResourceDeleter>(new (p) WidgetImpl(forward<Arg>(arg), resource), ResourceDeleter{resource});
+        }
+        catch (...)
+        {
+            resource->deallocate(p, sizeof(WidgetImpl), alignof(WidgetImpl));
+            throw;
+        }
+    }
+
+public:
+    using allocator_type = pmr::polymorphic_allocator<char>;
+
+    explicit Widget(int i = 0, allocator_type alloc = {})
+    : pimpl(create(alloc.resource(), i))
+    {
+
+    }
+
+    /* 같은 리소스면 포인터만 옮기고, 다른 리소스면 그 리소스에 새로 만든다. */
+    Widget(Widget&& rhs, allocator_type alloc = {})
+    : pimpl(rhs.pimpl.get_deleter().resource == alloc.resource()
+            ? move(rhs.pimpl)
+            : create(alloc.resource(), *rhs.pimpl))
+    {
+
+    }
+};
+
+struct Timing
+{
+    double build;
+    double destroy;
+};
+
+/* 생성과 소멸(리소스 반환 포함)을 따로 잰다. */
+template <typename T, typename MakeResource>
+Timing run(int n, MakeResource make_resource)
+{
+    Timing t{};
+
+    unique_ptr<pmr::memory_resource> resource = make_resource();
+    pmr::memory_resource* mr = resource ? resource.get() : pmr::new_delete_resource();
+
+    unique_ptr<pmr::vector<T>> v = make_unique<pmr::vector<T>>(mr);
+
+    steady_clock::time_point start = steady_clock::now();
+
+    for (int i = 0; i < n; ++i)
+        v->emplace_back(i);
+
+    steady_clock::time_point mid = steady_clock::now();
+
+    v.reset();
+    resource.reset();
+
+    steady_clock::time_point end = steady_clock::now();
+
+    t.build = duration<double>(mid - start).count();
+    t.destroy = duration<double>(end - mid).count();
+
+    return t;
+}
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+template <typename T, typename MakeResource>
+void report(const char* label, int n, int reps, MakeResource make_resource)
+{
+    vector<double> destroys;
+
+    vector<double> builds = run_bench([&] {
+        Timing t = run<T>(n, make_resource);
+        destroys.push_back(t.destroy);
+        return t.build;
+    }, kWarmup, reps);
+
+    /* 워밍업 실행의 소멸 시간은 버린다. */
+    destroys.erase(destroys.begin(), destroys.begin() + kWarmup);
+
+    cout << left << setw(24) << label << right
+         << "삽입 " << setw(10) << summarize(builds).median << " 초, "
+         << "소멸 " << setw(10) << summarize(destroys).median << " 초" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 3;
+
+    if (reps < 1)
+    {
+        cerr << "반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    auto new_delete = [] { return unique_ptr<pmr::memory_resource>(); };
+    auto monotonic = [] { return unique_ptr<pmr::memory_resource>(make_unique<pmr::monotonic_buffer_resource>()); };
+    auto pool = [] { return unique_ptr<pmr::memory_resource>(make_unique<pmr::unsynchronized_pool_resource>()); };
+
+    /* 데이터 멤버를 직접 복사하는 버전 */
+    report<WidgetImpl>("vw / new_delete", n, reps, new_delete);
+    report<WidgetImpl>("vw / monotonic", n, reps, monotonic);
+    report<WidgetImpl>("vw / pool", n, reps, pool);
+
+    /* Pimpl 포인터만 이동하는 버전 */
+    report<Widget>("vpimpl / new_delete", n, reps, new_delete);
+    report<Widget>("vpimpl / monotonic", n, reps, monotonic);
+    report<Widget>("vpimpl / pool", n, reps, pool);
+
+    return 0;
+}
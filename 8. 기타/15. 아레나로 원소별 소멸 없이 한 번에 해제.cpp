@@ -0,0 +1,381 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <type_traits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <new>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 아레나로 원소별 소멸 없이 한 번에 해제
+ *
+ * vw.clear() 나 스코프 종료 시에
+ * - vector<WidgetImpl> 는 3백만 개의 소멸자를 불러 name 을 하나씩 해제하고
+ * - vector<Widget> 은 3백만 개의 unique_ptr 이 impl 과 name 을 하나씩 해제한다.
+ * 기존 벤치마크는 이 해제 시간을 아예 재지 않았다.
+ *
+ * 아레나 모드
+ * - 위젯, 이름, impl, vector 버퍼까지 모두 하나의 아레나에서 할당한다.
+ * - 이름은 아레나 안의 문자열을 가리키는 ArenaString 이므로
+ *   위젯은 트리비얼하게 소멸 가능하고, 소멸자를 부를 필요가 없다.
+ * - vector 의 할당자는 해제를 무시하고, 마지막에 arena.release() 한 번으로
+ *   덩어리(chunk) 몇 개만 돌려준다.
+ *
+ * 대신 vector 가 커질 때 버려진 옛 버퍼도 release() 까지 남아 있다. (최대 2배 정도)
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+    friend class Widget;
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    WidgetImpl(const WidgetImpl& rhs)
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name)
+    {
+
+    }
+
+    /* noexcept 이 아니기 때문에 메모리 재할당 시에는 복사 생성이 사용된다. */
+    WidgetImpl(WidgetImpl&& rhs)
+        : i(move(rhs.i)), b(move(rhs.b)), c(move(rhs.c)), d(move(rhs.d)), name(move(rhs.name))
+    {
+
+    }
+};
+
+class Widget
+{
+    unique_ptr<WidgetImpl> pimpl;
+
+public:
+    Widget(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : pimpl(make_unique<WidgetImpl>(i, b, c, d, name))
+    {
+
+    }
+
+    /* vector 는 메모리 재할당 시에
+     * 이동 생성자가 noexcept 인 경우에만 복사 대신 이동을 한다. */
+    Widget(Widget&& rhs) : pimpl(move(rhs.pimpl))
+    {
+
+    }
+};
+
+/* 포인터를 증가시키며 할당하고, 해제는 release() 에서 한 번에 한다. */
+class Arena
+{
+    struct Chunk
+    {
+        Chunk* next;
+    };
+
+    static constexpr size_t kFirstChunk = 64 * 1024;
+
+    Chunk* chunks = nullptr;
+    char* cur = nullptr;
+    char* end = nullptr;
+    size_t next_chunk = kFirstChunk;
+
+    void add_chunk(size_t min_bytes)
+    {
+        size_t bytes = max(next_chunk, min_bytes + sizeof(Chunk) + alignof(max_align_t));
+        Chunk* chunk = static_cast<Chunk*>(malloc(bytes));
+
+        if (chunk == nullptr)
+            throw bad_alloc();
+
+        chunk->next = chunks;
+        chunks = chunk;
+
+        cur = reinterpret_cast<char*>(chunk) + sizeof(Chunk);
+        end = reinterpret_cast<char*>(chunk) + bytes;
+
+        next_chunk *= 2;
+    }
+
+public:
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator= (const Arena&) = delete;
+
+    ~Arena() { release(); }
+
+    void* allocate(size_t bytes, size_t align)
+    {
+        uintptr_t p = (reinterpret_cast<uintptr_t>(cur) + align - 1) & ~(uintptr_t(align) - 1);
+
+        if (cur == nullptr || p + bytes > reinterpret_cast<uintptr_t>(end))
+        {
+            add_chunk(bytes + align);
+            p = (reinterpret_cast<uintptr_t>(cur) + align - 1) & ~(uintptr_t(align) - 1);
+        }
+
+        cur = reinterpret_cast<char*>(p + bytes);
+
+        return reinterpret_cast<void*>(p);
+    }
+
+    /* 덩어리 수만큼만 free 한다. */
+    void release()
+    {
+        while (chunks != nullptr)
+        {
+            Chunk* next = chunks->next;
+            free(chunks);
+            chunks = next;
+        }
+
+        cur = end = nullptr;
+        next_chunk = kFirstChunk;
+    }
+};
+
+/* 해제를 무시하는 STL 할당자 */
+template <typename T>
+struct ArenaAllocator
+{
+    using value_type = T;
+
+    Arena* arena;
+
+    explicit ArenaAllocator(Arena& arena) : arena(&arena) { }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& rhs) : arena(rhs.arena) { }
+
+    T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) noexcept { }
+
+    template <typename U>
+    bool operator== (const ArenaAllocator<U>& rhs) const { return arena == rhs.arena; }
+
+    template <typename U>
+    bool operator!= (const ArenaAllocator<U>& rhs) const { return arena != rhs.arena; }
+};
+
+/* 아레나 안의 문자열을 가리키기만 한다. */
+struct ArenaString
+{
+    const char* data;
+    size_t len;
+
+    ArenaString(Arena& arena, const char* s) : len(strlen(s))
+    {
+        char* p = static_cast<char*>(arena.allocate(len + 1, 1));
+        memcpy(p, s, len + 1);
+        data = p;
+    }
+};
+
+struct ArenaWidgetImpl
+{
+    int i;
+    double b, c, d;
+    ArenaString name;
+    double arr[10];
+
+    ArenaWidgetImpl(Arena& arena, int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, const char* name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(arena, name), arr()
+    {
+
+    }
+};
+
+struct ArenaWidget
+{
+    ArenaWidgetImpl* pimpl;
+
+    ArenaWidget(Arena& arena, int i = 0)
+    : pimpl(new (arena.allocate(sizeof(ArenaWidgetImpl), alignof(ArenaWidgetImpl))) ArenaWidgetImpl(arena, i))
+    {
+
+    }
+};
+
+static_assert(is_trivially_destructible<ArenaWidgetImpl>::value, "아레나 위젯은 소멸자를 부르지 않아도 되어야 한다.");
+static_assert(is_trivially_destructible<ArenaWidget>::value, "아레나 위젯은 소멸자를 부르지 않아도 되어야 한다.");
+
+struct Timing
+{
+    double build;
+    double teardown;
+};
+
+template <typename Build, typename Teardown>
+Timing measure(Build build, Teardown teardown)
+{
+    steady_clock::time_point start = steady_clock::now();
+    build();
+    steady_clock::time_point mid = steady_clock::now();
+    teardown();
+    steady_clock::time_point end = steady_clock::now();
+
+    return Timing{duration<double>(mid - start).count(), duration<double>(end - mid).count()};
+}
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+template <typename Run>
+void report(const char* label, int reps, Run run)
+{
+    vector<double> teardowns;
+
+    vector<double> builds = run_bench([&] {
+        Timing t = run();
+        teardowns.push_back(t.teardown);
+        return t.build;
+    }, kWarmup, reps);
+
+    /* 워밍업 실행의 해제 시간은 버린다. */
+    teardowns.erase(teardowns.begin(), teardowns.begin() + kWarmup);
+
+    cout << label << ": 삽입 " << summarize(builds).median << " 초, 해제 " << summarize(teardowns).median << " 초" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 3;
+
+    if (reps < 1)
+    {
+        cerr << "반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    /* 원소마다 소멸자가 name 을 해제하는 버전 */
+    report("vw", reps, [&] {
+        vector<WidgetImpl> vw;
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                vw.push_back(WidgetImpl(i));
+        }, [&] {
+            vw.clear();
+            vw.shrink_to_fit();
+        });
+    });
+
+    /* 원소마다 unique_ptr 이 impl 과 name 을 해제하는 버전 */
+    report("vpimpl", reps, [&] {
+        vector<Widget> vpimpl;
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                vpimpl.push_back(Widget(i));
+        }, [&] {
+            vpimpl.clear();
+            vpimpl.shrink_to_fit();
+        });
+    });
+
+    /* 아레나 버전: 소멸자 없이 덩어리만 반환 */
+    report("vw 아레나", reps, [&] {
+        Arena arena;
+        vector<ArenaWidgetImpl, ArenaAllocator<ArenaWidgetImpl>> vw{ArenaAllocator<ArenaWidgetImpl>(arena)};
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                vw.push_back(ArenaWidgetImpl(arena, i));
+        }, [&] {
+            /* vector 는 트리비얼한 소멸자를 건너뛰고, 할당자의 해제는 아무 일도 하지 않는다. */
+            vw.clear();
+            vw.shrink_to_fit();
+            arena.release();
+        });
+    });
+
+    report("vpimpl 아레나", reps, [&] {
+        Arena arena;
+        vector<ArenaWidget, ArenaAllocator<ArenaWidget>> vpimpl{ArenaAllocator<ArenaWidget>(arena)};
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                vpimpl.push_back(ArenaWidget(arena, i));
+        }, [&] {
+            vpimpl.clear();
+            vpimpl.shrink_to_fit();
+            arena.release();
+        });
+    });
+
+    return 0;
+}
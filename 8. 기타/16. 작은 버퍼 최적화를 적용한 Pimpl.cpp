@@ -0,0 +1,263 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <cmath>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 작은 버퍼 최적화(SBO)를 적용한 Pimpl (fast Pimpl)
+ *
+ * Widget 은 항상 WidgetImpl 을 힙에 할당한다.
+ * - 삽입마다 할당이 한 번 더 일어나고
+ * - 순회할 때마다 포인터를 한 번 더 따라가야 한다.
+ *
+ * InlineWidget<Capacity> 는
+ * - WidgetImpl 이 Capacity 바이트 안에 들어가면 객체 안의 정렬된 버퍼에 직접 만들고
+ * - 들어가지 않으면 기존처럼 힙에 할당한다.
+ * 어느 쪽인지는 컴파일 시간에 정해진다.
+ *
+ * 인라인 버퍼를 쓰면 Widget 자체가 WidgetImpl 만큼 커지므로
+ * 재할당 때는 포인터 대신 impl 전체를 이동해야 한다.
+ * 그래서 impl 의 이동 생성자가 noexcept 이어야 하고, Widget 의 이동도 noexcept 로 유지한다.
+ *
+ * 힙으로 돌아가는 경우에는 버퍼를 두지 않고 포인터 하나 크기만 차지한다.
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    /* 인라인 저장소에서 옮길 수 있도록 noexcept 이동 생성자를 둔다. */
+    WidgetImpl(WidgetImpl&& rhs) noexcept = default;
+
+    double sum() const { return i + b + c + d; }
+};
+
+/* 기존 Pimpl */
+class Widget
+{
+    unique_ptr<WidgetImpl> pimpl;
+
+public:
+    Widget(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : pimpl(make_unique<WidgetImpl>(i, b, c, d, name))
+    {
+
+    }
+
+    Widget(Widget&& rhs) noexcept = default;
+
+    double sum() const { return pimpl->sum(); }
+};
+
+template <size_t Capacity, size_t Align = alignof(max_align_t)>
+class InlineWidget
+{
+    static constexpr bool kInline = sizeof(WidgetImpl) <= Capacity && alignof(WidgetImpl) <= Align;
+
+    static_assert(!kInline || is_nothrow_move_constructible<WidgetImpl>::value,
+                  "인라인 저장소는 noexcept 이동이 가능한 impl 만 담는다.");
+
+    /* 힙으로 돌아가면 Capacity 바이트 버퍼는 쓰지 않으므로 포인터 크기로 줄인다. */
+    static constexpr size_t kStorageSize = kInline ? Capacity : sizeof(WidgetImpl*);
+    static constexpr size_t kStorageAlign = kInline ? Align : alignof(WidgetImpl*);
+
+    union
+    {
+        alignas(kStorageAlign) unsigned char storage[kStorageSize];
+        WidgetImpl* heap;
+    };
+
+    WidgetImpl* impl() { return kInline ? reinterpret_cast<WidgetImpl*>(storage) : heap; }
+    const WidgetImpl* impl() const { return kInline ? reinterpret_cast<const WidgetImpl*>(storage) : heap; }
+
+public:
+    InlineWidget(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    {
+        if (kInline)
+            new (storage) WidgetImpl(i, b, c, d, move(name));
+        else
+            heap = new WidgetImpl(i, b, c, d, move(name));
+    }
+
+    InlineWidget(InlineWidget&& rhs) noexcept
+    {
+        if (kInline)
+            new (storage) WidgetImpl(move(*rhs.impl()));
+        else
+        {
+            heap = rhs.heap;
+            rhs.heap = nullptr;
+        }
+    }
+
+    InlineWidget(const InlineWidget&) = delete;
+    InlineWidget& operator= (const InlineWidget&) = delete;
+
+    ~InlineWidget()
+    {
+        if (kInline)
+            impl()->~WidgetImpl();
+        else
+            delete heap;
+    }
+
+    static constexpr bool is_inline() { return kInline; }
+
+    double sum() const { return impl()->sum(); }
+};
+
+template <typename F>
+double measure(F f)
+{
+    steady_clock::time_point start = steady_clock::now();
+    f();
+    steady_clock::time_point end = steady_clock::now();
+
+    return duration<double>(end - start).count();
+}
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+template <typename W>
+void run(const char* label, int n, int reps, double& sink)
+{
+    vector<double> scans;
+
+    vector<double> builds = run_bench([&] {
+        vector<W> v;
+
+        double build = measure([&] {
+            for (int i = 0; i < n; ++i)
+                v.push_back(W(i));
+        });
+
+        scans.push_back(measure([&] {
+            for (const W& w : v)
+                sink += w.sum();
+        }));
+
+        return build;
+    }, kWarmup, reps);
+
+    /* 워밍업 실행의 순회 시간은 버린다. */
+    scans.erase(scans.begin(), scans.begin() + kWarmup);
+
+    cout << label << " (sizeof " << sizeof(W) << "): 삽입 " << summarize(builds).median
+         << " 초, 순회 " << summarize(scans).median << " 초" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 5;
+    double sink = 0.0;
+
+    if (reps < 1)
+    {
+        cerr << "반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    using InlineStorage = InlineWidget<sizeof(WidgetImpl)>;
+    using HeapFallback = InlineWidget<64>;
+
+    static_assert(InlineStorage::is_inline(), "WidgetImpl 크기의 버퍼에는 인라인으로 들어가야 한다.");
+    static_assert(!HeapFallback::is_inline(), "64 바이트 버퍼에는 WidgetImpl 이 들어가지 않는다.");
+    static_assert(sizeof(HeapFallback) == sizeof(Widget), "힙으로 돌아가면 Widget 과 크기가 같아야 한다.");
+
+    /* 포인터만 이동하지만, 삽입마다 할당하고 순회마다 포인터를 따라간다. */
+    run<Widget>("Widget", n, reps, sink);
+
+    /* 할당과 포인터 추적이 없지만, 재할당 때 impl 전체를 이동한다. */
+    run<InlineStorage>("InlineWidget (인라인)", n, reps, sink);
+
+    /* 버퍼가 작으면 힙으로 돌아가므로 Widget 과 같은 동작을 한다. (sizeof 도 포인터 하나) */
+    run<HeapFallback>("InlineWidget (힙)", n, reps, sink);
+
+    cout << "체크섬: " << sink << endl;
+
+    return 0;
+}
@@ -0,0 +1,370 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * unique_ptr 대신 세대(generation) 번호가 있는 슬롯 맵(slot map) 핸들
+ *
+ * vector<Widget> 은 힙 여기저기에 흩어진 WidgetImpl 을 가리키는 8 바이트 포인터의 배열이다.
+ *
+ * WidgetSlotMap
+ * - WidgetImpl 은 빈틈 없이 하나의 vector(dense)에 모여 있다. → 순회가 연속 메모리 접근
+ * - Widget 은 4 바이트 핸들이다. (슬롯 번호 24 비트 + 세대 8 비트) → 핸들 배열이 절반 크기
+ * - 슬롯 테이블이 핸들의 슬롯 번호를 dense 위치로 바꿔 준다.
+ * - 삭제는 마지막 원소를 빈자리로 옮기는 것으로 끝난다. → O(1), 뒤쪽 원소를 밀지 않는다.
+ * - 삭제된 슬롯은 세대를 올려 자유 리스트에 넣으므로
+ *   옛 핸들로 접근하면 세대가 달라 무효임을 알 수 있다.
+ *
+ * 세대가 8 비트뿐이므로 한 슬롯을 255 번 재사용하면 그 슬롯은 더 쓰지 않는다. (세대가 돌아서 겹치지 않도록)
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    /* dense 배열이 재할당, 삭제 시에 이동할 수 있도록 noexcept 이동을 둔다. */
+    WidgetImpl(WidgetImpl&& rhs) noexcept = default;
+    WidgetImpl& operator= (WidgetImpl&& rhs) noexcept = default;
+
+    int id() const { return i; }
+    double sum() const { return i + b + c + d; }
+};
+
+/* 기존 Pimpl */
+class Widget
+{
+    unique_ptr<WidgetImpl> pimpl;
+
+public:
+    Widget(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : pimpl(make_unique<WidgetImpl>(i, b, c, d, name))
+    {
+
+    }
+
+    Widget(Widget&& rhs) noexcept = default;
+    Widget& operator= (Widget&& rhs) noexcept = default;
+
+    double sum() const { return pimpl->sum(); }
+};
+
+class WidgetHandle
+{
+    static constexpr uint32_t kIndexBits = 24;
+    static constexpr uint32_t kIndexMask = (uint32_t(1) << kIndexBits) - 1;
+
+    uint32_t bits;
+
+    friend class WidgetSlotMap;
+
+    WidgetHandle(uint32_t slot, uint32_t generation) : bits((generation << kIndexBits) | slot) { }
+
+    uint32_t slot() const { return bits & kIndexMask; }
+    uint32_t generation() const { return bits >> kIndexBits; }
+
+public:
+    static constexpr uint32_t kMaxSlots = kIndexMask + 1;
+    static constexpr uint32_t kMaxGeneration = 0xFF;
+};
+
+class WidgetSlotMap
+{
+    static constexpr uint32_t kNoFree = ~uint32_t(0);
+
+    struct Slot
+    {
+        uint32_t dense_or_next_free;    // 사용 중이면 dense 위치, 비어 있으면 다음 빈 슬롯
+        uint32_t generation;
+    };
+
+    vector<WidgetImpl> dense;
+    vector<uint32_t> dense_to_slot;
+    vector<Slot> slots;
+    uint32_t free_head = kNoFree;
+
+    bool valid(WidgetHandle h) const
+    {
+        return h.slot() < slots.size() && slots[h.slot()].generation == h.generation();
+    }
+
+public:
+    template <typename... Args>
+    WidgetHandle insert(Args&&... args)
+    {
+        uint32_t slot;
+        bool fresh = free_head == kNoFree;
+
+        if (!fresh)
+            slot = free_head;
+        else
+        {
+            if (slots.size() == WidgetHandle::kMaxSlots)
+                throw length_error("WidgetSlotMap: 슬롯이 가득 찼다.");
+
+            slot = static_cast<uint32_t>(slots.size());
+            slots.push_back(Slot{kNoFree, 0});
+        }
+
+        /* 예외가 나면 넣은 것을 모두 되돌려 슬롯 상태가 바뀌지 않게 한다. */
+        size_t old_size = dense.size();
+
+        try
+        {
+            dense.emplace_back(forward<Args>(args)...);
+            dense_to_slot.push_back(slot);
+        }
+        catch (...)
+        {
+            if (dense.size() > old_size)
+                dense.pop_back();
+
+            if (fresh)
+                slots.pop_back();
+
+            throw;
+        }
+
+        if (slot == free_head)
+            free_head = slots[slot].dense_or_next_free;
+
+        slots[slot].dense_or_next_free = static_cast<uint32_t>(dense.size() - 1);
+
+        return WidgetHandle(slot, slots[slot].generation);
+    }
+
+    /* 무효한(이미 삭제된) 핸들이면 nullptr */
+    WidgetImpl* get(WidgetHandle h)
+    {
+        return valid(h) ? &dense[slots[h.slot()].dense_or_next_free] : nullptr;
+    }
+
+    /* 마지막 원소를 빈자리로 옮긴다. 무효한 핸들이면 false */
+    bool erase(WidgetHandle h)
+    {
+        if (!valid(h))
+            return false;
+
+        uint32_t slot = h.slot();
+        uint32_t pos = slots[slot].dense_or_next_free;
+        uint32_t last = static_cast<uint32_t>(dense.size() - 1);
+
+        if (pos != last)
+        {
+            dense[pos] = move(dense[last]);
+            dense_to_slot[pos] = dense_to_slot[last];
+            slots[dense_to_slot[pos]].dense_or_next_free = pos;
+        }
+
+        dense.pop_back();
+        dense_to_slot.pop_back();
+
+        /* 세대를 올려 옛 핸들을 무효화한다. 세대가 다 찬 슬롯은 재사용하지 않는다. */
+        if (++slots[slot].generation <= WidgetHandle::kMaxGeneration)
+        {
+            slots[slot].dense_or_next_free = free_head;
+            free_head = slot;
+        }
+
+        return true;
+    }
+
+    size_t size() const { return dense.size(); }
+
+    /* 순회는 연속된 dense 배열만 훑는다. */
+    vector<WidgetImpl>::const_iterator begin() const { return dense.begin(); }
+    vector<WidgetImpl>::const_iterator end() const { return dense.end(); }
+};
+
+template <typename F>
+double measure(F f)
+{
+    steady_clock::time_point start = steady_clock::now();
+    f();
+    steady_clock::time_point end = steady_clock::now();
+
+    return duration<double>(end - start).count();
+}
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int erases = argc > 2 ? atoi(argv[2]) : 1000;
+    int reps = argc > 3 ? atoi(argv[3]) : 3;
+    double sink = 0.0;
+
+    if (n < 0 || erases < 0 || reps < 1)
+    {
+        cerr << "원소 수와 삭제 횟수는 0 이상, 반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    /* 삭제된 핸들은 무효로 판정된다. */
+    {
+        WidgetSlotMap map;
+        WidgetHandle a = map.insert(1);
+        WidgetHandle b = map.insert(2);
+
+        map.erase(a);
+        WidgetHandle c = map.insert(3);    // a 의 슬롯을 재사용
+
+        cout << "sizeof(WidgetHandle): " << sizeof(WidgetHandle) << ", sizeof(Widget): " << sizeof(Widget) << endl;
+        cout << boolalpha << "a 무효: " << (map.get(a) == nullptr)
+             << ", b = " << map.get(b)->id() << ", c = " << map.get(c)->id() << endl;
+    }
+
+    mt19937 rng(42);
+
+    /* 반복마다 새로 만들어 삽입, 순회, 삭제를 차례로 잰다. */
+
+    /* 기존 Pimpl: 삭제하면 뒤쪽 포인터를 모두 한 칸씩 당긴다. */
+    vector<double> vpimpl_scans, vpimpl_erases;
+    int vpimpl_erased = 0;
+
+    vector<double> vpimpl_builds = run_bench([&] {
+        vector<Widget> vpimpl;
+
+        double build = measure([&] {
+            for (int i = 0; i < n; ++i)
+                vpimpl.push_back(Widget(i));
+        });
+        vpimpl_scans.push_back(measure([&] {
+            for (const Widget& w : vpimpl)
+                sink += w.sum();
+        }));
+        vpimpl_erases.push_back(measure([&] {
+            for (vpimpl_erased = 0; vpimpl_erased < erases && !vpimpl.empty(); ++vpimpl_erased)
+                vpimpl.erase(vpimpl.begin() + rng() % vpimpl.size());
+        }));
+
+        return build;
+    }, kWarmup, reps);
+
+    /* 슬롯 맵: 핸들은 4 바이트, impl 은 연속 배열 */
+    vector<double> map_scans, map_erases;
+    int map_erased = 0;
+
+    vector<double> map_builds = run_bench([&] {
+        WidgetSlotMap map;
+        vector<WidgetHandle> handles;
+
+        double build = measure([&] {
+            for (int i = 0; i < n; ++i)
+                handles.push_back(map.insert(i));
+        });
+        map_scans.push_back(measure([&] {
+            for (const WidgetImpl& w : map)
+                sink += w.sum();
+        }));
+        /* 지운 핸들은 목록에서 빼서 매번 살아 있는 원소를 지운다. */
+        map_erases.push_back(measure([&] {
+            for (map_erased = 0; map_erased < erases && !handles.empty(); ++map_erased)
+            {
+                size_t k = rng() % handles.size();
+
+                map.erase(handles[k]);
+                handles[k] = handles.back();
+                handles.pop_back();
+            }
+        }));
+
+        return build;
+    }, kWarmup, reps);
+
+    /* 워밍업 실행의 순회, 삭제 시간은 버린다. */
+    for (vector<double>* samples : {&vpimpl_scans, &vpimpl_erases, &map_scans, &map_erases})
+        samples->erase(samples->begin(), samples->begin() + kWarmup);
+
+    cout << "vector<Widget>: 삽입 " << summarize(vpimpl_builds).median << " 초, 순회 " << summarize(vpimpl_scans).median
+         << " 초, 삭제 " << vpimpl_erased << " 회 " << summarize(vpimpl_erases).median << " 초" << endl;
+    cout << "WidgetSlotMap: 삽입 " << summarize(map_builds).median << " 초, 순회 " << summarize(map_scans).median
+         << " 초, 삭제 " << map_erased << " 회 " << summarize(map_erases).median << " 초" << endl;
+    cout << "체크섬: " << sink << endl;
+
+    return 0;
+}
@@ -0,0 +1,301 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <random>
+#include <iterator>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * Pimpl 순회의 포인터 추적과 소프트웨어 프리페치
+ *
+ * 실제로는 삽입보다 읽기가 훨씬 많다.
+ * vector<Widget> 을 순회하면 원소마다 pimpl 을 따라가는 의존적인 load 가 생기고,
+ * impl 들이 힙에 흩어져 있으면 매번 캐시 미스가 난다.
+ *
+ * 순회 벤치마크
+ * - b + c + d 합
+ * - arr 전체 합
+ * 을 vector<WidgetImpl>, vector<Widget>(삽입 순서), vector<Widget>(섞은 순서)에 대해 잰다.
+ *
+ * PrefetchIterator 는 k 칸 앞 원소의 impl 에 __builtin_prefetch 를 미리 걸어 둔다.
+ * - WidgetImpl 은 144 바이트이므로 캐시 라인 세 개를 모두 프리페치한다.
+ * - 포인터 값 자체는 vector 안에 연속으로 있으므로 미리 읽을 수 있다.
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+    friend class Widget;
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name), arr()
+    {
+        for (double& x : arr)
+            x = i;
+    }
+
+    WidgetImpl(const WidgetImpl& rhs) = default;
+
+    /* noexcept 이 아니기 때문에 메모리 재할당 시에는 복사 생성이 사용된다. */
+    WidgetImpl(WidgetImpl&& rhs)
+        : i(move(rhs.i)), b(move(rhs.b)), c(move(rhs.c)), d(move(rhs.d)), name(move(rhs.name))
+    {
+        copy(begin(rhs.arr), end(rhs.arr), arr);
+    }
+
+    double sum_bcd() const { return b + c + d; }
+
+    double sum_arr() const
+    {
+        double total = 0.0;
+
+        for (double x : arr)
+            total += x;
+
+        return total;
+    }
+};
+
+class Widget
+{
+    unique_ptr<WidgetImpl> pimpl;
+
+public:
+    Widget(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : pimpl(make_unique<WidgetImpl>(i, b, c, d, name))
+    {
+
+    }
+
+    Widget(Widget&& rhs) noexcept = default;
+    Widget& operator= (Widget&& rhs) noexcept = default;
+
+    const WidgetImpl& impl() const { return *pimpl; }
+};
+
+/* impl 이 걸쳐 있는 캐시 라인을 모두 읽기용으로 프리페치한다. */
+inline void prefetch_impl(const WidgetImpl* p)
+{
+    const char* bytes = reinterpret_cast<const char*>(p);
+
+    for (size_t offset = 0; offset < sizeof(WidgetImpl); offset += 64)
+        __builtin_prefetch(bytes + offset, 0, 3);
+}
+
+/* k 칸 앞 원소의 impl 을 프리페치하며 나아가는 반복자 (k >= 0)
+ * 생성할 때 앞쪽 k 개를 미리 거는 등 부수 효과가 있으므로 range-for 용 입력 반복자로만 둔다. */
+class PrefetchIterator
+{
+    vector<Widget>::const_iterator cur, last;
+    ptrdiff_t distance;
+
+    void prefetch_ahead() const
+    {
+        if (last - cur > distance)
+            prefetch_impl(&cur[distance].impl());
+    }
+
+public:
+    using iterator_category = input_iterator_tag;
+    using value_type = WidgetImpl;
+    using difference_type = ptrdiff_t;
+    using pointer = const WidgetImpl*;
+    using reference = const WidgetImpl&;
+
+    PrefetchIterator(vector<Widget>::const_iterator cur, vector<Widget>::const_iterator last, ptrdiff_t distance)
+    : cur(cur), last(last), distance(distance)
+    {
+        /* 처음 k 개는 미리 걸어 둔다. */
+        for (ptrdiff_t k = 0; k < distance && k < last - cur; ++k)
+            prefetch_impl(&cur[k].impl());
+    }
+
+    reference operator* () const { return cur->impl(); }
+    pointer operator-> () const { return &cur->impl(); }
+
+    PrefetchIterator& operator++ ()
+    {
+        prefetch_ahead();
+        ++cur;
+
+        return *this;
+    }
+
+    PrefetchIterator operator++ (int)
+    {
+        PrefetchIterator old = *this;
+        ++*this;
+
+        return old;
+    }
+
+    bool operator== (const PrefetchIterator& rhs) const { return cur == rhs.cur; }
+    bool operator!= (const PrefetchIterator& rhs) const { return cur != rhs.cur; }
+};
+
+/* 프리페치하며 순회하는 범위 */
+struct PrefetchRange
+{
+    const vector<Widget>& v;
+    ptrdiff_t distance;
+
+    PrefetchIterator begin() const { return PrefetchIterator(v.begin(), v.end(), distance); }
+    PrefetchIterator end() const { return PrefetchIterator(v.end(), v.end(), 0); }
+};
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+template <typename F>
+double measure(F f)
+{
+    steady_clock::time_point start = steady_clock::now();
+    f();
+    steady_clock::time_point end = steady_clock::now();
+
+    return duration<double>(end - start).count();
+}
+
+/* f 한 번의 실행 시간을 하네스로 반복해 잰 중앙값 */
+template <typename F>
+double median_of(int reps, F f)
+{
+    return summarize(run_bench([&] { return measure(f); }, kWarmup, reps)).median;
+}
+
+void print_row(const char* label, double bcd, double arr)
+{
+    cout << label << ": b+c+d " << bcd << " 초, arr " << arr << " 초" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 5;
+    ptrdiff_t distance = argc > 3 ? atoi(argv[3]) : 8;
+    double sink = 0.0;
+
+    if (n < 0 || reps < 1 || distance < 0)
+    {
+        cerr << "원소 수와 프리페치 거리는 0 이상, 반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    /* impl 사이에 다른 할당이 끼지 않도록 vpimpl 을 먼저, 따로 만든다.
+     * reserve 로 vector 재할당이 남기는 빈 버퍼에 impl 이 들어가는 일도 막는다. */
+    vector<Widget> vpimpl;
+    vpimpl.reserve(n);
+    for (int i = 0; i < n; ++i)
+        vpimpl.push_back(Widget(i));
+
+    vector<WidgetImpl> vw;
+    for (int i = 0; i < n; ++i)
+        vw.push_back(WidgetImpl(i));
+
+    /* 섞어서 impl 이 메모리상 순서와 무관하게 흩어진 상황을 만든다. */
+    vector<Widget> scattered;
+    for (int i = 0; i < n; ++i)
+        scattered.push_back(Widget(i));
+    shuffle(scattered.begin(), scattered.end(), mt19937(42));
+
+    /* 연속 배열: 포인터 추적 없음 */
+    print_row("vw",
+              median_of(reps, [&] { for (const WidgetImpl& w : vw) sink += w.sum_bcd(); }),
+              median_of(reps, [&] { for (const WidgetImpl& w : vw) sink += w.sum_arr(); }));
+
+    /* 할당 순서대로라면 impl 도 대체로 연속이라 하드웨어 프리페처가 따라온다. */
+    print_row("vpimpl",
+              median_of(reps, [&] { for (const Widget& w : vpimpl) sink += w.impl().sum_bcd(); }),
+              median_of(reps, [&] { for (const Widget& w : vpimpl) sink += w.impl().sum_arr(); }));
+
+    print_row("vpimpl 프리페치",
+              median_of(reps, [&] { for (const WidgetImpl& w : PrefetchRange{vpimpl, distance}) sink += w.sum_bcd(); }),
+              median_of(reps, [&] { for (const WidgetImpl& w : PrefetchRange{vpimpl, distance}) sink += w.sum_arr(); }));
+
+    /* 흩어진 impl: 원소마다 캐시 미스 */
+    print_row("vpimpl 섞음",
+              median_of(reps, [&] { for (const Widget& w : scattered) sink += w.impl().sum_bcd(); }),
+              median_of(reps, [&] { for (const Widget& w : scattered) sink += w.impl().sum_arr(); }));
+
+    print_row("vpimpl 섞음 프리페치",
+              median_of(reps, [&] { for (const WidgetImpl& w : PrefetchRange{scattered, distance}) sink += w.sum_bcd(); }),
+              median_of(reps, [&] { for (const WidgetImpl& w : PrefetchRange{scattered, distance}) sink += w.sum_arr(); }));
+
+    cout << "프리페치 거리: " << distance << ", 체크섬: " << sink << endl;
+
+    return 0;
+}
@@ -0,0 +1,277 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 흩어진 WidgetImpl 을 연속 블록으로 모으는 압축(compaction)
+ *
+ * make_unique<WidgetImpl> 을 수백만 번 하는 사이사이에
+ * name 등 다른 크기의 할당이 끼어들면 impl 들은 힙 여기저기에 흩어진다.
+ * 정렬이나 삭제로 vector 순서와 메모리 순서가 어긋나면 더 심해진다.
+ *
+ * WidgetVector::compact()
+ * - 원소 수만큼의 연속된 슬랩을 한 번에 할당하고
+ * - vector 순서대로 WidgetImpl 을 슬랩으로 이동한 뒤
+ * - 각 Widget 의 pimpl 을 새 위치로 바꾼다.
+ * 이후의 순회는 다시 연속 메모리를 순서대로 읽는다.
+ *
+ * 슬랩 안의 impl 은 개별 delete 할 수 없으므로
+ * Widget 은 소유권 없는 포인터만 들고, 해제는 WidgetVector 가 맡는다.
+ * (주소가 슬랩 범위 안이면 소멸자만, 아니면 delete)
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    /* 슬랩으로 옮길 때 name 을 복사하지 않도록 noexcept 이동을 둔다. */
+    WidgetImpl(WidgetImpl&& rhs) noexcept = default;
+
+    int id() const { return i; }
+    double sum() const { return i + b + c + d; }
+};
+
+class Widget
+{
+    WidgetImpl* pimpl;
+
+    friend class WidgetVector;
+
+    explicit Widget(WidgetImpl* pimpl) : pimpl(pimpl) { }
+
+public:
+    const WidgetImpl& impl() const { return *pimpl; }
+};
+
+class WidgetVector
+{
+    vector<Widget> widgets;
+
+    WidgetImpl* slab = nullptr;
+    size_t slab_count = 0;
+
+    bool in_slab(const WidgetImpl* p) const
+    {
+        return slab != nullptr && p >= slab && p < slab + slab_count;
+    }
+
+    void destroy(WidgetImpl* p)
+    {
+        if (in_slab(p))
+            p->~WidgetImpl();
+        else
+            delete p;
+    }
+
+public:
+    WidgetVector() = default;
+    WidgetVector(const WidgetVector&) = delete;
+    WidgetVector& operator= (const WidgetVector&) = delete;
+
+    ~WidgetVector()
+    {
+        for (Widget& w : widgets)
+            destroy(w.pimpl);
+
+        ::operator delete(slab);
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args)
+    {
+        unique_ptr<WidgetImpl> impl = make_unique<WidgetImpl>(forward<Args>(args)...);
+
+        widgets.push_back(Widget(impl.get()));
+        impl.release();
+    }
+
+    const Widget& operator[] (size_t idx) const { return widgets[idx]; }
+    size_t size() const { return widgets.size(); }
+
+    vector<Widget>::const_iterator begin() const { return widgets.begin(); }
+    vector<Widget>::const_iterator end() const { return widgets.end(); }
+
+    /* 순서를 바꿔도 impl 의 메모리 위치는 그대로다. */
+    template <typename Compare>
+    void sort_by(Compare comp)
+    {
+        sort(widgets.begin(), widgets.end(), [&](const Widget& lhs, const Widget& rhs) {
+            return comp(*lhs.pimpl, *rhs.pimpl);
+        });
+    }
+
+    /* 모든 impl 을 vector 순서대로 새 슬랩 하나에 모은다. */
+    void compact()
+    {
+        WidgetImpl* fresh = static_cast<WidgetImpl*>(::operator new(widgets.size() * sizeof(WidgetImpl)));
+
+        /* noexcept 이동이므로 중간에 실패하지 않는다. */
+        for (size_t idx = 0; idx < widgets.size(); ++idx)
+        {
+            WidgetImpl* old = widgets[idx].pimpl;
+
+            new (fresh + idx) WidgetImpl(move(*old));
+            destroy(old);
+
+            widgets[idx].pimpl = fresh + idx;
+        }
+
+        ::operator delete(slab);
+        slab = fresh;
+        slab_count = widgets.size();
+    }
+};
+
+double scan(const WidgetVector& v)
+{
+    double total = 0.0;
+
+    for (const Widget& w : v)
+        total += w.impl().sum();
+
+    return total;
+}
+
+template <typename F>
+double measure(F f)
+{
+    steady_clock::time_point start = steady_clock::now();
+    f();
+    steady_clock::time_point end = steady_clock::now();
+
+    return duration<double>(end - start).count();
+}
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+/* f 한 번의 실행 시간을 하네스로 반복해 잰 중앙값 */
+template <typename F>
+double median_of(int reps, F f)
+{
+    return summarize(run_bench([&] { return measure(f); }, kWarmup, reps)).median;
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 5;
+    double sink = 0.0;
+
+    if (reps < 1)
+    {
+        cerr << "반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    mt19937 rng(42);
+    WidgetVector v;
+
+    /* impl 할당 사이사이에 크기가 제각각인 다른 할당을 끼워 넣는다. */
+    {
+        vector<string> noise;
+        uniform_int_distribution<int> len(16, 512);
+
+        for (int i = 0; i < n; ++i)
+        {
+            v.emplace_back(static_cast<int>(rng() % n));
+            noise.push_back(string(len(rng), 'x'));
+        }
+    }
+
+    /* 정렬로 vector 순서와 메모리 순서를 어긋나게 만든다. */
+    v.sort_by([](const WidgetImpl& lhs, const WidgetImpl& rhs) { return lhs.id() < rhs.id(); });
+
+    double before = median_of(reps, [&] { sink += scan(v); });
+    double compact_time = measure([&] { v.compact(); });
+    double after = median_of(reps, [&] { sink += scan(v); });
+
+    cout << "압축 전 순회: " << before << " 초" << endl;
+    cout << "압축: " << compact_time << " 초" << endl;
+    cout << "압축 후 순회: " << after << " 초" << endl;
+    cout << "체크섬: " << sink << endl;
+
+    return 0;
+}
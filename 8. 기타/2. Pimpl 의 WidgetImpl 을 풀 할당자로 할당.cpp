@@ -0,0 +1,328 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * Pimpl 의 WidgetImpl 을 풀 할당자로 할당
+ *
+ * Pimpl 버전의 단점
+ * - 모든 원소가 make_unique 로 각각 동적 할당되므로
+ * - 삽입 속도가 느려지고, 메모리 단편화가 심해진다.
+ *
+ * 크기 클래스별 슬랩(slab) 풀
+ * - 같은 크기의 슬롯을 연속된 블록 단위로 할당해 두고 하나씩 나눠준다.
+ * - 해제된 슬롯은 자유 리스트에 넣었다가 다시 사용한다.
+ * - 블록 크기를 2배씩 키우므로 3백만 개도 블록 할당 십여 번이면 된다.
+ * - 연속으로 생성된 impl 들이 메모리상에서도 이웃하게 된다.
+ *
+ * unique_ptr 에 커스텀 삭제자를 주면
+ * delete 대신 풀에 슬롯을 돌려줄 수 있다.
+ */
+
+template <size_t Size, size_t Align>
+class SlabPool
+{
+    /* 빈 슬롯은 자유 리스트의 노드로 사용한다. */
+    union Slot
+    {
+        Slot* next;
+        alignas(Align) unsigned char storage[Size];
+    };
+
+    vector<Slot*> blocks;
+    Slot* free_list = nullptr;
+    size_t next_block_slots;
+
+    void grow()
+    {
+        Slot* block = static_cast<Slot*>(::operator new(next_block_slots * sizeof(Slot)));
+        blocks.push_back(block);
+
+        /* 앞쪽 슬롯부터 나가도록 뒤에서부터 자유 리스트에 넣는다. */
+        for (size_t i = next_block_slots; i-- > 0; )
+        {
+            block[i].next = free_list;
+            free_list = &block[i];
+        }
+
+        next_block_slots *= 2;
+    }
+
+public:
+    explicit SlabPool(size_t first_block_slots = 1024) : next_block_slots(first_block_slots) { }
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator= (const SlabPool&) = delete;
+
+    /* 살아 있는 객체가 남아 있지 않은 상태에서 소멸해야 한다. */
+    ~SlabPool()
+    {
+        for (Slot* block : blocks)
+            ::operator delete(block);
+    }
+
+    void* allocate()
+    {
+        if (free_list == nullptr)
+            grow();
+
+        Slot* slot = free_list;
+        free_list = slot->next;
+
+        return slot;
+    }
+
+    void deallocate(void* p) noexcept
+    {
+        Slot* slot = static_cast<Slot*>(p);
+        slot->next = free_list;
+        free_list = slot;
+    }
+
+    size_t block_count() const { return blocks.size(); }
+};
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+    friend class Widget;
+    friend class PooledWidget;
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    double sum() const { return i + b + c + d; }
+};
+
+/* WidgetImpl 크기 클래스의 풀 */
+using WidgetImplPool = SlabPool<sizeof(WidgetImpl), alignof(WidgetImpl)>;
+
+WidgetImplPool& widget_impl_pool()
+{
+    static WidgetImplPool pool;
+
+    return pool;
+}
+
+struct PoolDeleter
+{
+    void operator() (WidgetImpl* p) const noexcept
+    {
+        p->~WidgetImpl();
+        widget_impl_pool().deallocate(p);
+    }
+};
+
+/* 기존 Pimpl: 원소마다 make_unique */
+class Widget
+{
+    unique_ptr<WidgetImpl> pimpl;
+
+public:
+    Widget(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : pimpl(make_unique<WidgetImpl>(i, b, c, d, name))
+    {
+
+    }
+
+    Widget(Widget&& rhs) noexcept = default;
+
+    double sum() const { return pimpl->sum(); }
+};
+
+/* 풀 Pimpl: 풀의 슬롯에 placement new */
+class PooledWidget
+{
+    unique_ptr<WidgetImpl, PoolDeleter> pimpl;
+
+    static WidgetImpl* create(int i, double b, double c, double d, const string& name)
+    {
+        void* slot = widget_impl_pool().allocate();
+
+        try
+        {
+            return new (slot) WidgetImpl(i, b, c, d, name);
+        }
+        catch (...)
+        {
+            widget_impl_pool().deallocate(slot);
+            throw;
+        }
+    }
+
+public:
+    PooledWidget(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : pimpl(create(i, b, c, d, name))
+    {
+
+    }
+
+    PooledWidget(PooledWidget&& rhs) noexcept = default;
+
+    double sum() const { return pimpl->sum(); }
+};
+
+template <typename F>
+double measure(F f)
+{
+    steady_clock::time_point start = steady_clock::now();
+    f();
+    steady_clock::time_point end = steady_clock::now();
+
+    return duration<double>(end - start).count();
+}
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+template <typename W>
+double traverse(const vector<W>& v)
+{
+    double total = 0.0;
+
+    for (const W& w : v)
+        total += w.sum();
+
+    return total;
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 5;
+    double sink = 0.0;
+
+    if (reps < 1)
+    {
+        cerr << "반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    /*
+     * make_unique 버전
+     *
+     * 원소마다 WidgetImpl 할당이 한 번씩 일어난다.
+     */
+    double heap_build = summarize(run_bench([&] {
+        vector<Widget> vpimpl;
+        double t = measure([&] {
+            for (int i = 0; i < n; ++i)
+                vpimpl.push_back(Widget(i));
+        });
+        sink += traverse(vpimpl);
+        return t;
+    }, kWarmup, reps)).median;
+
+    vector<Widget> vpimpl;
+    for (int i = 0; i < n; ++i)
+        vpimpl.push_back(Widget(i));
+    double heap_scan = summarize(run_bench([&] { return measure([&] { sink += traverse(vpimpl); }); }, kWarmup, reps)).median;
+    vpimpl.clear();
+
+    /*
+     * 풀 버전
+     *
+     * WidgetImpl 할당은 블록 단위로만 일어나고,
+     * 두 번째 반복부터는 자유 리스트의 슬롯을 재사용한다.
+     */
+    double pool_build = summarize(run_bench([&] {
+        vector<PooledWidget> vpool;
+        double t = measure([&] {
+            for (int i = 0; i < n; ++i)
+                vpool.push_back(PooledWidget(i));
+        });
+        sink += traverse(vpool);
+        return t;
+    }, kWarmup, reps)).median;
+
+    vector<PooledWidget> vpool;
+    for (int i = 0; i < n; ++i)
+        vpool.push_back(PooledWidget(i));
+    double pool_scan = summarize(run_bench([&] { return measure([&] { sink += traverse(vpool); }); }, kWarmup, reps)).median;
+
+    cout << "make_unique 삽입: " << heap_build << " 초, 순회: " << heap_scan << " 초" << endl;
+    cout << "풀 삽입: " << pool_build << " 초, 순회: " << pool_scan << " 초" << endl;
+    cout << "풀 블록 할당 횟수: " << widget_impl_pool().block_count() << endl;
+    cout << "체크섬: " << sink << endl;
+
+    return 0;
+}
@@ -0,0 +1,431 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 스레드 풀로 위젯 벡터를 병렬 생성
+ *
+ * (빌드: g++ -O2 -pthread)
+ *
+ * 3백만 개를 push_back 으로 만드는 루프는 코어 하나만 쓴다.
+ *
+ * bulk_build(pool, n, make)
+ * - 목적지를 n 개 크기로 한 번만 할당하고 (초기화하지 않은 메모리)
+ * - 풀의 스레드마다 겹치지 않는 구간 [lo, hi) 를 맡아
+ *   make(idx) 로 얻은 인자로 원소를 그 자리에 바로 생성(placement new)한다.
+ * 재할당도, 원소 이동도, 스레드 간 잠금도 없다.
+ *
+ * Widget 의 경우 스레드마다 impl 과 name 을 할당하므로
+ * malloc 의 스레드별 아레나가 병렬 확장성을 좌우한다.
+ *
+ * 어떤 스레드에서 생성자가 예외를 던지면
+ * 이미 만든 원소를 모두 소멸시키고 예외를 다시 던진다.
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+    friend class Widget;
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    WidgetImpl(const WidgetImpl& rhs)
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name)
+    {
+
+    }
+
+    /* noexcept 이 아니기 때문에 메모리 재할당 시에는 복사 생성이 사용된다. */
+    WidgetImpl(WidgetImpl&& rhs)
+        : i(move(rhs.i)), b(move(rhs.b)), c(move(rhs.c)), d(move(rhs.d)), name(move(rhs.name))
+    {
+
+    }
+
+    double sum() const { return i + b + c + d; }
+};
+
+class Widget
+{
+    unique_ptr<WidgetImpl> pimpl;
+
+public:
+    Widget(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : pimpl(make_unique<WidgetImpl>(i, b, c, d, name))
+    {
+
+    }
+
+    /* vector 는 메모리 재할당 시에
+     * 이동 생성자가 noexcept 인 경우에만 복사 대신 이동을 한다. */
+    Widget(Widget&& rhs) : pimpl(move(rhs.pimpl))
+    {
+
+    }
+
+    double sum() const { return pimpl->sum(); }
+};
+
+/* 같은 작업을 모든 작업 스레드에 한 번씩 맡기고 끝날 때까지 기다린다. */
+class ThreadPool
+{
+    vector<thread> workers;
+
+    mutex m;
+    condition_variable wake, done;
+    function<void(unsigned)> job;
+    unsigned long round = 0;
+    unsigned remaining = 0;
+    bool stopping = false;
+
+    void loop(unsigned index)
+    {
+        unsigned long seen = 0;
+
+        for (;;)
+        {
+            function<void(unsigned)>* current;
+
+            {
+                unique_lock<mutex> lock(m);
+                wake.wait(lock, [&] { return stopping || round != seen; });
+
+                if (stopping)
+                    return;
+
+                seen = round;
+                current = &job;
+            }
+
+            (*current)(index);
+
+            {
+                lock_guard<mutex> lock(m);
+                if (--remaining == 0)
+                    done.notify_one();
+            }
+        }
+    }
+
+public:
+    explicit ThreadPool(unsigned count)
+    {
+        if (count == 0)
+            throw invalid_argument("ThreadPool: 스레드가 하나 이상 있어야 한다.");
+
+        for (unsigned index = 0; index < count; ++index)
+            workers.emplace_back(&ThreadPool::loop, this, index);
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator= (const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            lock_guard<mutex> lock(m);
+            stopping = true;
+        }
+
+        wake.notify_all();
+
+        for (thread& t : workers)
+            t.join();
+    }
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+    /* f 는 예외를 던지지 않아야 한다. */
+    void run(function<void(unsigned)> f)
+    {
+        unique_lock<mutex> lock(m);
+
+        job = move(f);
+        remaining = size();
+        ++round;
+
+        wake.notify_all();
+        done.wait(lock, [&] { return remaining == 0; });
+    }
+};
+
+/* 크기가 고정된 초기화되지 않은 저장소. bulk_build 만 원소를 채운다. */
+template <typename T>
+class BulkArray
+{
+    T* data = nullptr;
+    size_t count = 0;
+
+    template <typename U, typename Make>
+    friend BulkArray<U> bulk_build(ThreadPool& pool, size_t n, Make make);
+
+public:
+    BulkArray() = default;
+    BulkArray(const BulkArray&) = delete;
+    BulkArray& operator= (const BulkArray&) = delete;
+
+    BulkArray(BulkArray&& rhs) noexcept : data(rhs.data), count(rhs.count)
+    {
+        rhs.data = nullptr;
+        rhs.count = 0;
+    }
+
+    BulkArray& operator= (BulkArray&& rhs) noexcept
+    {
+        swap(data, rhs.data);
+        swap(count, rhs.count);
+
+        return *this;
+    }
+
+    ~BulkArray()
+    {
+        for (size_t idx = 0; idx < count; ++idx)
+            data[idx].~T();
+
+        ::operator delete(data);
+    }
+
+    size_t size() const { return count; }
+
+    const T* begin() const { return data; }
+    const T* end() const { return data + count; }
+};
+
+template <typename T, typename Make>
+BulkArray<T> bulk_build(ThreadPool& pool, size_t n, Make make)
+{
+    BulkArray<T> out;
+    out.data = static_cast<T*>(::operator new(n * sizeof(T)));
+
+    unsigned parts = pool.size();
+    vector<size_t> built(parts, 0);
+    vector<exception_ptr> errors(parts);
+
+    pool.run([&](unsigned part) {
+        size_t lo = n * part / parts;
+        size_t hi = n * (part + 1) / parts;
+
+        /* 이웃 구간의 built 와 같은 캐시 라인이므로 반복 중에는 지역 변수만 센다. */
+        size_t local = 0;
+
+        try
+        {
+            for (size_t idx = lo; idx < hi; ++idx)
+            {
+                new (out.data + idx) T(make(idx));
+                ++local;
+            }
+        }
+        catch (...)
+        {
+            errors[part] = current_exception();
+        }
+
+        built[part] = local;
+    });
+
+    /* 구간마다 앞에서부터 built 개가 만들어져 있다. */
+    for (exception_ptr& e : errors)
+    {
+        if (!e)
+            continue;
+
+        for (unsigned part = 0; part < parts; ++part)
+        {
+            size_t lo = n * part / parts;
+
+            for (size_t idx = lo; idx < lo + built[part]; ++idx)
+                out.data[idx].~T();
+        }
+
+        rethrow_exception(e);
+    }
+
+    out.count = n;
+
+    return out;
+}
+
+template <typename F>
+double measure(F f)
+{
+    steady_clock::time_point start = steady_clock::now();
+    f();
+    steady_clock::time_point end = steady_clock::now();
+
+    return duration<double>(end - start).count();
+}
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+/* 생성 시간만 잰다. 결과 배열은 타이머 밖에서 소멸시킨다. */
+template <typename T, typename Make>
+double median_build(int reps, ThreadPool& pool, size_t n, Make make, double& sink)
+{
+    return summarize(run_bench([&] {
+        BulkArray<T> v;
+
+        double t = measure([&] { v = bulk_build<T>(pool, n, make); });
+
+        if (v.size() > 0)
+            sink += v.end()[-1].sum();
+
+        return t;
+    }, kWarmup, reps)).median;
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int max_threads = argc > 2 ? atoi(argv[2]) : max(1u, thread::hardware_concurrency());
+    int reps = argc > 3 ? atoi(argv[3]) : 3;
+    double sink = 0.0;
+
+    if (n < 0 || max_threads < 1 || reps < 1)
+    {
+        cerr << "원소 수는 0 이상, 스레드 수와 반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    /* 기준: 한 스레드에서 push_back */
+    double vw_serial = summarize(run_bench([&] {
+        vector<WidgetImpl> vw;
+
+        double t = measure([&] {
+            for (int i = 0; i < n; ++i)
+                vw.push_back(WidgetImpl(i));
+        });
+
+        if (!vw.empty())
+            sink += vw.back().sum();
+
+        return t;
+    }, kWarmup, reps)).median;
+
+    double vpimpl_serial = summarize(run_bench([&] {
+        vector<Widget> vpimpl;
+
+        double t = measure([&] {
+            for (int i = 0; i < n; ++i)
+                vpimpl.push_back(Widget(i));
+        });
+
+        if (!vpimpl.empty())
+            sink += vpimpl.back().sum();
+
+        return t;
+    }, kWarmup, reps)).median;
+
+    cout << "push_back: vw " << vw_serial << " 초, vpimpl " << vpimpl_serial << " 초" << endl;
+
+    /* 1, 2, 4, ... 와 마지막으로 max_threads 에서 속도 향상 곡선을 만든다. */
+    vector<unsigned> counts;
+    for (unsigned threads = 1; threads < static_cast<unsigned>(max_threads); threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(max_threads);
+
+    /* make(idx) 가 생성자 인자를 돌려주므로 원소는 제자리에서 바로 만들어진다. */
+    auto make = [](size_t idx) { return static_cast<int>(idx); };
+
+    for (unsigned threads : counts)
+    {
+        ThreadPool pool(threads);
+
+        double vw_bulk = median_build<WidgetImpl>(reps, pool, n, make, sink);
+        double vpimpl_bulk = median_build<Widget>(reps, pool, n, make, sink);
+
+        cout << "스레드 " << threads << ": vw " << vw_bulk << " 초 (x" << vw_serial / vw_bulk << "), vpimpl "
+             << vpimpl_bulk << " 초 (x" << vpimpl_serial / vpimpl_bulk << ")" << endl;
+    }
+
+    cout << "체크섬: " << sink << endl;
+
+    return 0;
+}
@@ -0,0 +1,599 @@
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 작업 훔치기(work stealing) 스레드 풀로 위젯 일괄 처리
+ *
+ * (빌드: g++ -O2 -pthread)
+ *
+ * 구간을 스레드 수만큼 똑같이 나누면(정적 분할)
+ * 원소마다 비용이 다를 때 한 스레드만 늦게 끝나고 나머지는 논다.
+ *
+ * WorkStealingPool
+ * - 작업 스레드마다 자기 덱(deque)이 있다.
+ * - 구간 [lo, hi) 를 꺼내면 grain 보다 클 동안 반으로 나눠 뒤쪽 절반을 자기 덱 뒤에 넣는다.
+ *   자기는 덱 뒤에서 꺼내므로(LIFO) 방금 나눈 작은 조각을 이어서 처리한다.
+ * - 자기 덱이 비면 다른 스레드 덱의 앞에서 훔친다. 앞쪽에는 가장 큰 조각이 남아 있다.
+ * - 덱은 스레드마다 뮤텍스 하나로 보호한다. (잠금은 조각 단위로만 잡는다.)
+ *
+ * parallel_for, parallel_reduce 는 vector<WidgetImpl>, vector<Widget> 모두에 쓸 수 있다.
+ *
+ * 벤치마크는 뒤쪽 1/16 의 name 을 1024 자로 길게 만들고 name 해시를 구한다.
+ * 정적 분할이면 마지막 스레드에 긴 이름이 몰린다.
+ * 불균형 = 가장 바빴던 스레드의 작업 시간 / 평균 작업 시간 (1 이면 완벽, 반복 중 가장 나쁜 값)
+ * 작업 시간은 벽시계 시간이므로 코어보다 스레드가 많으면 부풀려진다.
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+    friend class Widget;
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    WidgetImpl(const WidgetImpl& rhs)
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name)
+    {
+
+    }
+
+    /* noexcept 이 아니기 때문에 메모리 재할당 시에는 복사 생성이 사용된다. */
+    WidgetImpl(WidgetImpl&& rhs)
+        : i(move(rhs.i)), b(move(rhs.b)), c(move(rhs.c)), d(move(rhs.d)), name(move(rhs.name))
+    {
+
+    }
+
+    /* name 길이에 비례하는 비용 */
+    size_t name_hash() const { return hash<string>()(name); }
+};
+
+class Widget
+{
+    unique_ptr<WidgetImpl> pimpl;
+
+public:
+    Widget(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : pimpl(make_unique<WidgetImpl>(i, b, c, d, name))
+    {
+
+    }
+
+    /* vector 는 메모리 재할당 시에
+     * 이동 생성자가 noexcept 인 경우에만 복사 대신 이동을 한다. */
+    Widget(Widget&& rhs) : pimpl(move(rhs.pimpl))
+    {
+
+    }
+
+    size_t name_hash() const { return pimpl->name_hash(); }
+};
+
+class WorkStealingPool
+{
+    /* 한 번의 run() 호출 */
+    struct Job
+    {
+        function<void(unsigned, size_t, size_t)> body;
+        size_t grain;
+        atomic<size_t> remaining;   // 아직 처리되지 않은 원소 수
+
+        mutex m;
+        condition_variable finished;
+        bool done = false;
+        exception_ptr error;
+    };
+
+    struct Task
+    {
+        Job* job;
+        size_t lo, hi;
+    };
+
+    /* 덱과 통계가 다른 스레드와 같은 캐시 라인을 쓰지 않도록 정렬한다. */
+    struct alignas(64) Worker
+    {
+        mutex m;
+        deque<Task> tasks;
+        double busy = 0.0;
+    };
+
+    vector<Worker> workers;
+    vector<thread> threads;
+
+    atomic<size_t> queued{0};
+    mutex sleep_m;
+    condition_variable wake;
+    bool stopping = false;
+    unsigned next_submit = 0;
+
+    void push(unsigned self, Task t)
+    {
+        {
+            lock_guard<mutex> lock(workers[self].m);
+            workers[self].tasks.push_back(t);
+        }
+
+        queued.fetch_add(1);
+
+        /* 잠자러 가는 중인 스레드가 queued 증가를 놓치지 않도록 잠금을 한 번 거친다. */
+        {
+            lock_guard<mutex> lock(sleep_m);
+        }
+        wake.notify_one();
+    }
+
+    bool pop_local(unsigned self, Task& t)
+    {
+        lock_guard<mutex> lock(workers[self].m);
+
+        if (workers[self].tasks.empty())
+            return false;
+
+        t = workers[self].tasks.back();
+        workers[self].tasks.pop_back();
+        queued.fetch_sub(1);
+
+        return true;
+    }
+
+    bool steal(unsigned self, uint32_t& seed, Task& t)
+    {
+        unsigned count = static_cast<unsigned>(workers.size());
+
+        /* xorshift 로 훔치기 시작할 희생자를 고른다. */
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+
+        for (unsigned k = 0; k < count; ++k)
+        {
+            unsigned victim = (seed + k) % count;
+
+            if (victim == self)
+                continue;
+
+            lock_guard<mutex> lock(workers[victim].m);
+
+            if (workers[victim].tasks.empty())
+                continue;
+
+            t = workers[victim].tasks.front();
+            workers[victim].tasks.pop_front();
+            queued.fetch_sub(1);
+
+            return true;
+        }
+
+        return false;
+    }
+
+    void execute(unsigned self, Task t)
+    {
+        Job& job = *t.job;
+
+        /* 큰 구간은 반씩 잘라 뒤쪽을 덱에 남긴다. 훔치는 쪽은 큰 조각부터 가져간다. */
+        while (t.hi - t.lo > job.grain)
+        {
+            size_t mid = t.lo + (t.hi - t.lo) / 2;
+            push(self, Task{&job, mid, t.hi});
+            t.hi = mid;
+        }
+
+        steady_clock::time_point start = steady_clock::now();
+
+        try
+        {
+            job.body(self, t.lo, t.hi);
+        }
+        catch (...)
+        {
+            lock_guard<mutex> lock(job.m);
+            if (!job.error)
+                job.error = current_exception();
+        }
+
+        workers[self].busy += duration<double>(steady_clock::now() - start).count();
+
+        if (job.remaining.fetch_sub(t.hi - t.lo) == t.hi - t.lo)
+        {
+            /* 잠금을 쥔 채로 알려야 run() 이 먼저 끝나 job 을 없애는 일이 없다. */
+            lock_guard<mutex> lock(job.m);
+            job.done = true;
+            job.finished.notify_all();
+        }
+    }
+
+    void loop(unsigned self)
+    {
+        uint32_t seed = 2463534242u + self;
+        Task t;
+
+        for (;;)
+        {
+            if (pop_local(self, t) || steal(self, seed, t))
+            {
+                execute(self, t);
+                continue;
+            }
+
+            unique_lock<mutex> lock(sleep_m);
+            wake.wait(lock, [&] { return stopping || queued.load() > 0; });
+
+            if (stopping)
+                return;
+        }
+    }
+
+public:
+    explicit WorkStealingPool(unsigned count) : workers(count)
+    {
+        if (count == 0)
+            throw invalid_argument("WorkStealingPool: 스레드가 하나 이상 있어야 한다.");
+
+        for (unsigned self = 0; self < count; ++self)
+            threads.emplace_back(&WorkStealingPool::loop, this, self);
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator= (const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool()
+    {
+        {
+            lock_guard<mutex> lock(sleep_m);
+            stopping = true;
+        }
+
+        wake.notify_all();
+
+        for (thread& t : threads)
+            t.join();
+    }
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+    /* body(worker, lo, hi) 가 [0, n) 을 겹치지 않게 한 번씩 처리한다. 끝날 때까지 기다린다. */
+    void run(size_t n, size_t grain, function<void(unsigned, size_t, size_t)> body)
+    {
+        if (n == 0)
+            return;
+
+        Job job;
+        job.body = move(body);
+        job.grain = max<size_t>(grain, 1);
+        job.remaining = n;
+
+        push(next_submit++ % size(), Task{&job, 0, n});
+
+        unique_lock<mutex> lock(job.m);
+        job.finished.wait(lock, [&] { return job.done; });
+
+        if (job.error)
+            rethrow_exception(job.error);
+    }
+
+    /* 작업 스레드마다 body 를 실행한 누적 시간 */
+    vector<double> busy_times() const
+    {
+        vector<double> times;
+
+        for (const Worker& w : workers)
+            times.push_back(w.busy);
+
+        return times;
+    }
+
+    /* 작업이 없을 때만 부른다. */
+    void reset_stats()
+    {
+        for (Worker& w : workers)
+            w.busy = 0.0;
+    }
+};
+
+template <typename T, typename F>
+void parallel_for(WorkStealingPool& pool, vector<T>& v, F f, size_t grain = 1024)
+{
+    pool.run(v.size(), grain, [&](unsigned, size_t lo, size_t hi) {
+        for (size_t idx = lo; idx < hi; ++idx)
+            f(v[idx]);
+    });
+}
+
+/* init 은 combine 의 항등원이어야 한다. 결합 순서는 정해져 있지 않다. */
+template <typename T, typename R, typename Map, typename Combine>
+R parallel_reduce(WorkStealingPool& pool, const vector<T>& v, R init, Map map, Combine combine, size_t grain = 1024)
+{
+    struct alignas(64) Partial
+    {
+        R value;
+    };
+
+    vector<Partial> partials(pool.size(), Partial{init});
+
+    pool.run(v.size(), grain, [&](unsigned worker, size_t lo, size_t hi) {
+        R local = init;
+
+        for (size_t idx = lo; idx < hi; ++idx)
+            local = combine(local, map(v[idx]));
+
+        partials[worker].value = combine(partials[worker].value, local);
+    });
+
+    R result = init;
+
+    for (const Partial& p : partials)
+        result = combine(result, p.value);
+
+    return result;
+}
+
+/* 비교용: 스레드마다 같은 개수의 원소를 맡긴다.
+ * 스레드 생성 비용이 섞이지 않도록 먼저 띄워 두고,
+ * 출발 신호부터 마지막 스레드가 끝날 때까지를 elapsed 로 돌려준다. */
+template <typename T, typename R, typename Map, typename Combine>
+R static_reduce(unsigned count, const vector<T>& v, R init, Map map, Combine combine, vector<double>& busy, double& elapsed)
+{
+    vector<R> partials(count, init);
+    vector<steady_clock::time_point> finished(count);
+    vector<thread> threads;
+
+    mutex m;
+    condition_variable go;
+    bool started = false;
+
+    busy.assign(count, 0.0);
+
+    for (unsigned part = 0; part < count; ++part)
+    {
+        threads.emplace_back([&, part] {
+            {
+                unique_lock<mutex> lock(m);
+                go.wait(lock, [&] { return started; });
+            }
+
+            size_t lo = v.size() * part / count;
+            size_t hi = v.size() * (part + 1) / count;
+            steady_clock::time_point begin = steady_clock::now();
+            R local = init;
+
+            for (size_t idx = lo; idx < hi; ++idx)
+                local = combine(local, map(v[idx]));
+
+            partials[part] = local;
+            finished[part] = steady_clock::now();
+            busy[part] = duration<double>(finished[part] - begin).count();
+        });
+    }
+
+    steady_clock::time_point start;
+    {
+        lock_guard<mutex> lock(m);
+        start = steady_clock::now();
+        started = true;
+    }
+
+    go.notify_all();
+
+    for (thread& t : threads)
+        t.join();
+
+    elapsed = duration<double>(*max_element(finished.begin(), finished.end()) - start).count();
+
+    R result = init;
+
+    for (const R& p : partials)
+        result = combine(result, p);
+
+    return result;
+}
+
+double imbalance(const vector<double>& busy)
+{
+    double total = 0.0, most = 0.0;
+
+    for (double b : busy)
+    {
+        total += b;
+        most = max(most, b);
+    }
+
+    return total > 0.0 ? most / (total / busy.size()) : 1.0;
+}
+
+template <typename F>
+double measure(F f)
+{
+    steady_clock::time_point start = steady_clock::now();
+    f();
+    steady_clock::time_point end = steady_clock::now();
+
+    return duration<double>(end - start).count();
+}
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+/* 뒤쪽 1/16 은 name 이 길어 해시 비용이 크다. */
+string skewed_name(int i, int n)
+{
+    return i >= n - n / 16 ? string(1024, 'A') : string("AAAAAAAAAAAAAABBBBBBBBBBB");
+}
+
+template <typename T>
+void run(const char* label, const vector<T>& v, WorkStealingPool& pool, int reps, size_t& sink)
+{
+    auto map = [](const T& w) { return w.name_hash(); };
+    auto combine = [](size_t lhs, size_t rhs) { return lhs + rhs; };
+
+    vector<double> fixed, stealing, fixed_imbalance, stealing_imbalance;
+
+    vector<double> serial = run_bench([&] {
+        double t = measure([&] {
+            for (const T& w : v)
+                sink += map(w);
+        });
+
+        vector<double> busy;
+        double elapsed = 0.0;
+        sink += static_reduce(pool.size(), v, size_t(0), map, combine, busy, elapsed);
+        fixed.push_back(elapsed);
+        fixed_imbalance.push_back(imbalance(busy));
+
+        pool.reset_stats();
+        stealing.push_back(measure([&] { sink += parallel_reduce(pool, v, size_t(0), map, combine); }));
+        stealing_imbalance.push_back(imbalance(pool.busy_times()));
+
+        return t;
+    }, kWarmup, reps);
+
+    /* 워밍업 실행의 값은 버린다. */
+    for (vector<double>* samples : {&fixed, &stealing, &fixed_imbalance, &stealing_imbalance})
+        samples->erase(samples->begin(), samples->begin() + kWarmup);
+
+    cout << label << ": 직렬 " << summarize(serial).median << " 초, 정적 분할 " << summarize(fixed).median
+         << " 초 (불균형 " << summarize(fixed_imbalance).max << "), 작업 훔치기 " << summarize(stealing).median
+         << " 초 (불균형 " << summarize(stealing_imbalance).max << ")" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int threads = argc > 2 ? atoi(argv[2]) : max(1u, thread::hardware_concurrency());
+    int reps = argc > 3 ? atoi(argv[3]) : 3;
+    size_t sink = 0;
+
+    if (n < 0 || threads < 1 || reps < 1)
+    {
+        cerr << "원소 수는 0 이상, 스레드 수와 반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    WorkStealingPool pool(threads);
+
+    cout << "스레드 " << pool.size() << endl;
+
+    {
+        vector<WidgetImpl> vw;
+        for (int i = 0; i < n; ++i)
+            vw.push_back(WidgetImpl(i, 0.0, 0.0, 0.0, skewed_name(i, n)));
+
+        run("vw", vw, pool, reps, sink);
+    }
+
+    {
+        vector<Widget> vpimpl;
+        for (int i = 0; i < n; ++i)
+            vpimpl.push_back(Widget(i, 0.0, 0.0, 0.0, skewed_name(i, n)));
+
+        run("vpimpl", vpimpl, pool, reps, sink);
+
+        /* parallel_for: 원소마다 같은 일을 나눠서 한다. */
+        vector<size_t> hashes(vpimpl.size());
+        size_t next = 0;
+        for (size_t& h : hashes)
+            h = next++;
+
+        double transform = measure([&] {
+            parallel_for(pool, hashes, [&](size_t& h) { h = vpimpl[h].name_hash(); });
+        });
+
+        cout << "vpimpl parallel_for: " << transform << " 초" << endl;
+
+        for (size_t h : hashes)
+            sink += h;
+    }
+
+    cout << "체크섬: " << sink << endl;
+
+    return 0;
+}
@@ -0,0 +1,313 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 잠금 없이 여러 스레드가 추가하는 분할(segmented) 컨테이너
+ *
+ * (빌드: g++ -O2 -pthread)
+ *
+ * 여러 생산자 스레드가 vw 에 넣으려면 push_back 을 뮤텍스로 감싸야 한다.
+ * - 모든 삽입이 한 줄로 서고
+ * - 재할당하는 동안(원소 전부 복사) 모든 생산자가 멈춘다.
+ *
+ * ConcurrentAppendVector
+ * - 자리 번호는 fetch_add 한 번으로 얻는다.
+ * - 저장소는 2배씩 커지는 블록이다. (4. 분할 vector 와 같은 위치 계산)
+ *   블록은 한 번 만들면 옮기지 않으므로 재할당이 없다.
+ * - 블록 포인터가 비어 있으면 만들어서 compare_exchange 로 끼워 넣고, 진 쪽은 자기 블록을 버린다.
+ *   calloc 은 큰 블록을 mmap 으로 받아오므로 버려지는 블록은 거의 비용이 없다.
+ * - 원소를 다 만든 뒤 자리의 ready 를 release 로 세운다.
+ *   읽는 쪽은 ready 를 acquire 로 확인한 원소만 본다. (잠금 없음)
+ *
+ * 생성자가 예외를 던진 자리는 ready 가 서지 않은 빈자리로 남는다.
+ * 소멸은 모든 스레드가 끝난 뒤에만 한다.
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+    friend class Widget;
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    WidgetImpl(const WidgetImpl& rhs)
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name)
+    {
+
+    }
+
+    /* noexcept 이 아니기 때문에 메모리 재할당 시에는 복사 생성이 사용된다. */
+    WidgetImpl(WidgetImpl&& rhs)
+        : i(move(rhs.i)), b(move(rhs.b)), c(move(rhs.c)), d(move(rhs.d)), name(move(rhs.name))
+    {
+
+    }
+
+    int id() const { return i; }
+};
+
+template <typename T, size_t First = 1024>
+class ConcurrentAppendVector
+{
+    static_assert(First > 0 && (First & (First - 1)) == 0, "First 는 2의 거듭제곱이어야 한다.");
+
+    static constexpr size_t kMaxBlocks = 40;
+
+    /* calloc 의 0 바이트가 곧 ready == false 이다. */
+    struct Slot
+    {
+        atomic<bool> ready;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* get() { return reinterpret_cast<T*>(storage); }
+    };
+
+    atomic<Slot*> blocks[kMaxBlocks] = {};
+    atomic<size_t> claimed{0};
+
+    static constexpr int log2_of(size_t x) { return x == 1 ? 0 : 1 + log2_of(x >> 1); }
+
+    static constexpr int kFirstShift = log2_of(First);
+
+    static int high_bit(size_t x) { return 63 - __builtin_clzll(x); }
+
+    static pair<size_t, size_t> locate(size_t idx)
+    {
+        size_t biased = idx + First;
+        int h = high_bit(biased);
+
+        return { h - kFirstShift, biased - (size_t(1) << h) };
+    }
+
+    static size_t block_size(size_t block) { return First << block; }
+
+    Slot* block_for(size_t block)
+    {
+        Slot* p = blocks[block].load(memory_order_acquire);
+
+        if (p != nullptr)
+            return p;
+
+        Slot* fresh = static_cast<Slot*>(calloc(block_size(block), sizeof(Slot)));
+
+        if (fresh == nullptr)
+            throw bad_alloc();
+
+        if (blocks[block].compare_exchange_strong(p, fresh, memory_order_acq_rel, memory_order_acquire))
+            return fresh;
+
+        /* 다른 스레드가 먼저 끼워 넣었다. */
+        free(fresh);
+
+        return p;
+    }
+
+public:
+    ConcurrentAppendVector() = default;
+    ConcurrentAppendVector(const ConcurrentAppendVector&) = delete;
+    ConcurrentAppendVector& operator= (const ConcurrentAppendVector&) = delete;
+
+    ~ConcurrentAppendVector()
+    {
+        size_t count = claimed.load();
+
+        for (size_t idx = 0; idx < count; ++idx)
+        {
+            pair<size_t, size_t> pos = locate(idx);
+            Slot* block = blocks[pos.first].load();
+
+            if (block != nullptr && block[pos.second].ready.load())
+                block[pos.second].get()->~T();
+        }
+
+        for (atomic<Slot*>& block : blocks)
+            free(block.load());
+    }
+
+    /* 여러 스레드가 동시에 불러도 된다. 원소의 주소는 바뀌지 않는다. */
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        size_t idx = claimed.fetch_add(1, memory_order_relaxed);
+        pair<size_t, size_t> pos = locate(idx);
+
+        if (pos.first >= kMaxBlocks)
+            throw length_error("ConcurrentAppendVector: 블록이 가득 찼다.");
+
+        Slot& slot = block_for(pos.first)[pos.second];
+        T* p = new (slot.storage) T(forward<Args>(args)...);
+
+        slot.ready.store(true, memory_order_release);
+
+        return *p;
+    }
+
+    /* 자리를 얻은 원소 수. 아직 만드는 중인 원소도 포함한다. */
+    size_t size() const { return claimed.load(memory_order_acquire); }
+
+    /* 완성되어 공개된 원소만 방문한다. 추가와 동시에 불러도 된다. */
+    template <typename F>
+    size_t for_each_published(F f) const
+    {
+        size_t count = size(), visited = 0;
+
+        for (size_t idx = 0; idx < count; ++idx)
+        {
+            pair<size_t, size_t> pos = locate(idx);
+            Slot* block = blocks[pos.first].load(memory_order_acquire);
+
+            if (block == nullptr || !block[pos.second].ready.load(memory_order_acquire))
+                continue;
+
+            f(*block[pos.second].get());
+            ++visited;
+        }
+
+        return visited;
+    }
+};
+
+/* 비교용: 뮤텍스로 감싼 vector<WidgetImpl> */
+class LockedVector
+{
+    mutable mutex m;
+    vector<WidgetImpl> v;
+
+public:
+    void push_back(WidgetImpl&& w)
+    {
+        lock_guard<mutex> lock(m);
+        v.push_back(move(w));
+    }
+
+    template <typename F>
+    size_t for_each_published(F f) const
+    {
+        lock_guard<mutex> lock(m);
+
+        for (const WidgetImpl& w : v)
+            f(w);
+
+        return v.size();
+    }
+};
+
+template <typename F>
+double measure(F f)
+{
+    steady_clock::time_point start = steady_clock::now();
+    f();
+    steady_clock::time_point end = steady_clock::now();
+
+    return duration<double>(end - start).count();
+}
+
+struct RunResult
+{
+    double seconds;
+    long long reader_passes;
+};
+
+/* producers 개의 스레드가 n 개를 나눠 넣는 동안 읽는 스레드 하나가 계속 훑는다. */
+template <typename Container, typename Push>
+RunResult run_producers(Container& c, int n, unsigned producers, Push push, long long& sink)
+{
+    atomic<bool> producing{true};
+    long long passes = 0;
+
+    thread reader([&] {
+        while (producing.load(memory_order_acquire))
+        {
+            sink += c.for_each_published([&](const WidgetImpl& w) { sink += w.id(); });
+            ++passes;
+        }
+    });
+
+    double seconds = measure([&] {
+        vector<thread> threads;
+
+        for (unsigned part = 0; part < producers; ++part)
+        {
+            threads.emplace_back([&, part] {
+                int lo = static_cast<int>(static_cast<long long>(n) * part / producers);
+                int hi = static_cast<int>(static_cast<long long>(n) * (part + 1) / producers);
+
+                for (int i = lo; i < hi; ++i)
+                    push(c, i);
+            });
+        }
+
+        for (thread& t : threads)
+            t.join();
+    });
+
+    producing.store(false, memory_order_release);
+    reader.join();
+
+    return RunResult{seconds, passes};
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int max_threads = argc > 2 ? atoi(argv[2]) : max(1u, thread::hardware_concurrency());
+    long long sink = 0;
+
+    if (n < 0 || max_threads < 1)
+    {
+        cerr << "원소 수는 0 이상, 스레드 수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    vector<unsigned> counts;
+    for (unsigned threads = 1; threads < static_cast<unsigned>(max_threads); threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(max_threads);
+
+    for (unsigned producers : counts)
+    {
+        RunResult locked, lock_free;
+        size_t published;
+
+        {
+            LockedVector v;
+            locked = run_producers(v, n, producers, [](LockedVector& c, int i) { c.push_back(WidgetImpl(i)); }, sink);
+        }
+
+        {
+            ConcurrentAppendVector<WidgetImpl> v;
+            lock_free = run_producers(v, n, producers, [](ConcurrentAppendVector<WidgetImpl>& c, int i) { c.emplace_back(i); }, sink);
+            published = v.for_each_published([](const WidgetImpl&) { });
+        }
+
+        cout << "생산자 " << producers << ": 뮤텍스 vector " << n / locked.seconds / 1e6 << " M/초 (읽기 "
+             << locked.reader_passes << " 회), 잠금 없는 컨테이너 " << n / lock_free.seconds / 1e6 << " M/초 (읽기 "
+             << lock_free.reader_passes << " 회, 공개 " << published << " 개)" << endl;
+    }
+
+    cout << "체크섬: " << sink << endl;
+
+    return 0;
+}
@@ -0,0 +1,382 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 스레드별 버퍼에 나눠 만들고 병렬로 합치기
+ *
+ * (빌드: g++ -O2 -pthread)
+ *
+ * 공유 컨테이너에 여러 스레드가 넣으면 잠금이든 원자 연산이든 경합이 생긴다.
+ *
+ * ShardedBuilder
+ * - 스레드마다 자기 vector(shard)에만 넣는다. 경합이 전혀 없다.
+ * - shard 는 캐시 라인 단위로 정렬되어 있어서
+ *   서로 다른 스레드의 vector 헤더(포인터, 크기)가 같은 캐시 라인을 쓰지 않는다. (false sharing 없음)
+ * - merge() 는 shard 크기의 누적 합(prefix sum)으로 각 shard 가 들어갈 위치를 구하고,
+ *   shard 마다 스레드 하나가 자기 구간에 원소를 이동 생성한다.
+ *   이동이 끝난 shard 의 빈 껍데기도 같은 스레드가 정리한다.
+ *
+ * 결과는 한 번에 할당한 연속 배열이다.
+ * vector 로 받으려면 resize() 가 3백만 개를 기본 생성(name 할당)해야 하므로
+ * 초기화하지 않은 저장소를 쓰는 BulkArray 로 받는다.
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+    friend class Widget;
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    WidgetImpl(const WidgetImpl& rhs)
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name)
+    {
+
+    }
+
+    /* noexcept 이 아니기 때문에 메모리 재할당 시에는 복사 생성이 사용된다. */
+    WidgetImpl(WidgetImpl&& rhs)
+        : i(move(rhs.i)), b(move(rhs.b)), c(move(rhs.c)), d(move(rhs.d)), name(move(rhs.name))
+    {
+
+    }
+
+    int id() const { return i; }
+};
+
+/* 크기가 고정된 연속 배열. merge() 만 원소를 채운다. */
+template <typename T>
+class BulkArray
+{
+    T* data = nullptr;
+    size_t count = 0;
+
+    template <typename U>
+    friend class ShardedBuilder;
+
+public:
+    BulkArray() = default;
+    BulkArray(const BulkArray&) = delete;
+    BulkArray& operator= (const BulkArray&) = delete;
+
+    BulkArray(BulkArray&& rhs) noexcept : data(rhs.data), count(rhs.count)
+    {
+        rhs.data = nullptr;
+        rhs.count = 0;
+    }
+
+    BulkArray& operator= (BulkArray&& rhs) noexcept
+    {
+        swap(data, rhs.data);
+        swap(count, rhs.count);
+
+        return *this;
+    }
+
+    ~BulkArray()
+    {
+        for (size_t idx = 0; idx < count; ++idx)
+            data[idx].~T();
+
+        ::operator delete(data);
+    }
+
+    size_t size() const { return count; }
+
+    const T* begin() const { return data; }
+    const T* end() const { return data + count; }
+};
+
+template <typename T>
+class ShardedBuilder
+{
+    struct alignas(64) Shard
+    {
+        vector<T> items;
+    };
+
+    vector<Shard> shards;
+
+public:
+    explicit ShardedBuilder(unsigned count) : shards(count) { }
+
+    unsigned size() const { return static_cast<unsigned>(shards.size()); }
+
+    /* k 번 스레드만 shard(k) 에 접근한다. */
+    vector<T>& shard(unsigned k) { return shards[k].items; }
+
+    /* 모든 shard 를 shard 순서대로 이어 붙인다. 끝나면 shard 는 비어 있다. */
+    BulkArray<T> merge()
+    {
+        unsigned count = size();
+        vector<size_t> offsets(count + 1, 0);
+
+        for (unsigned k = 0; k < count; ++k)
+            offsets[k + 1] = offsets[k] + shards[k].items.size();
+
+        BulkArray<T> out;
+        out.data = static_cast<T*>(::operator new(offsets[count] * sizeof(T)));
+
+        vector<size_t> built(count, 0);
+        vector<exception_ptr> errors(count);
+        vector<thread> threads;
+
+        for (unsigned k = 0; k < count; ++k)
+        {
+            threads.emplace_back([&, k] {
+                vector<T>& items = shards[k].items;
+                T* dest = out.data + offsets[k];
+
+                /* 이웃 shard 의 built 와 같은 캐시 라인이므로 반복 중에는 지역 변수만 센다. */
+                size_t local = 0;
+
+                try
+                {
+                    for (T& item : items)
+                    {
+                        new (dest + local) T(move(item));
+                        ++local;
+                    }
+
+                    /* 이동하고 남은 껍데기와 버퍼도 이 스레드가 정리한다. */
+                    vector<T>().swap(items);
+                }
+                catch (...)
+                {
+                    errors[k] = current_exception();
+                }
+
+                built[k] = local;
+            });
+        }
+
+        for (thread& t : threads)
+            t.join();
+
+        /* shard 마다 앞에서부터 built 개가 만들어져 있다. */
+        for (exception_ptr& e : errors)
+        {
+            if (!e)
+                continue;
+
+            for (unsigned k = 0; k < count; ++k)
+            {
+                for (size_t idx = offsets[k]; idx < offsets[k] + built[k]; ++idx)
+                    out.data[idx].~T();
+            }
+
+            rethrow_exception(e);
+        }
+
+        out.count = offsets[count];
+
+        return out;
+    }
+};
+
+template <typename F>
+double measure(F f)
+{
+    steady_clock::time_point start = steady_clock::now();
+    f();
+    steady_clock::time_point end = steady_clock::now();
+
+    return duration<double>(end - start).count();
+}
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+/* threads 개의 스레드가 [0, n) 을 나눠 body(k, i) 를 부른다. */
+template <typename Body>
+void run_threads(int n, unsigned threads, Body body)
+{
+    vector<thread> workers;
+
+    for (unsigned k = 0; k < threads; ++k)
+    {
+        workers.emplace_back([&, k] {
+            int lo = static_cast<int>(static_cast<long long>(n) * k / threads);
+            int hi = static_cast<int>(static_cast<long long>(n) * (k + 1) / threads);
+
+            for (int i = lo; i < hi; ++i)
+                body(k, i);
+        });
+    }
+
+    for (thread& t : workers)
+        t.join();
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int max_threads = argc > 2 ? atoi(argv[2]) : 64;
+    int reps = argc > 3 ? atoi(argv[3]) : 3;
+    long long sink = 0;
+
+    if (n < 0 || max_threads < 1 || reps < 1)
+    {
+        cerr << "원소 수는 0 이상, 스레드 수와 반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    /* 기준: 한 스레드에서 vw 를 만드는 원래 루프 */
+    double serial = summarize(run_bench([&] {
+        vector<WidgetImpl> vw;
+
+        double t = measure([&] {
+            for (int i = 0; i < n; ++i)
+                vw.push_back(WidgetImpl(i));
+        });
+
+        if (!vw.empty())
+            sink += vw.back().id();
+
+        return t;
+    }, kWarmup, reps)).median;
+
+    cout << "vw 한 스레드: " << serial << " 초" << endl;
+
+    vector<unsigned> counts;
+    for (unsigned threads = 1; threads < static_cast<unsigned>(max_threads); threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(max_threads);
+
+    for (unsigned threads : counts)
+    {
+        /* 모든 스레드가 뮤텍스 하나를 두고 경합한다. */
+        double locked = summarize(run_bench([&] {
+            mutex m;
+            vector<WidgetImpl> vw;
+
+            double t = measure([&] {
+                run_threads(n, threads, [&](unsigned, int i) {
+                    WidgetImpl w(i);
+                    lock_guard<mutex> lock(m);
+                    vw.push_back(move(w));
+                });
+            });
+
+            if (!vw.empty())
+                sink += vw.back().id();
+
+            return t;
+        }, kWarmup, reps)).median;
+
+        /* 스레드마다 자기 shard 에만 넣고, 마지막에 합친다. */
+        vector<double> merges;
+
+        vector<double> builds = run_bench([&] {
+            ShardedBuilder<WidgetImpl> builder(threads);
+            BulkArray<WidgetImpl> merged;
+
+            double t = measure([&] {
+                run_threads(n, threads, [&](unsigned k, int i) { builder.shard(k).push_back(WidgetImpl(i)); });
+            });
+            merges.push_back(measure([&] { merged = builder.merge(); }));
+
+            if (merged.size() > 0)
+                sink += merged.end()[-1].id();
+
+            return t;
+        }, kWarmup, reps);
+
+        /* 워밍업 실행의 merge 시간은 버린다. */
+        merges.erase(merges.begin(), merges.begin() + kWarmup);
+
+        double build = summarize(builds).median;
+        double merge = summarize(merges).median;
+
+        cout << "스레드 " << threads << ": 뮤텍스 vector " << locked << " 초, shard 생성 " << build
+             << " 초 + merge " << merge << " 초 = " << build + merge << " 초" << endl;
+    }
+
+    cout << "체크섬: " << sink << endl;
+
+    return 0;
+}
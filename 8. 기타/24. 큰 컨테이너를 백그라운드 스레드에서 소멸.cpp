@@ -0,0 +1,326 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 큰 컨테이너를 백그라운드 스레드에서 소멸
+ *
+ * (빌드: g++ -O2 -pthread)
+ *
+ * 3백만 개의 WidgetImpl(name 해제) 이나 Widget(impl, name 해제)을 없애는 데는 시간이 꽤 걸리고,
+ * 그 시간은 clear() 를 부르거나 스코프를 벗어나는 스레드가 고스란히 떠안는다.
+ *
+ * DeferredReclaimer::dispose(move(container))
+ * - 컨테이너를 이동해 버퍼의 소유권만 넘겨받는다. (vector 라면 포인터 세 개, O(1))
+ * - 작은 상자 하나에 담아 큐에 넣고 바로 돌아온다.
+ * - 회수 스레드가 큐에서 꺼내 원소의 소멸자와 해제를 대신 한다.
+ *
+ * 호출한 쪽의 clear 시간은 거의 0 이 되고, 해제 비용은 다른 코어로 옮겨 간다.
+ * 해제 중에도 할당자는 공유하므로, 할당이 많은 작업과 겹치면 malloc 잠금 경합은 남는다.
+ * 코어가 하나뿐이면 깨어난 회수 스레드가 호출 스레드를 밀어내므로 호출 쪽 시간도 늘어난다.
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+    friend class Widget;
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    WidgetImpl(const WidgetImpl& rhs)
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name)
+    {
+
+    }
+
+    /* noexcept 이 아니기 때문에 메모리 재할당 시에는 복사 생성이 사용된다. */
+    WidgetImpl(WidgetImpl&& rhs)
+        : i(move(rhs.i)), b(move(rhs.b)), c(move(rhs.c)), d(move(rhs.d)), name(move(rhs.name))
+    {
+
+    }
+};
+
+class Widget
+{
+    unique_ptr<WidgetImpl> pimpl;
+
+public:
+    Widget(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : pimpl(make_unique<WidgetImpl>(i, b, c, d, name))
+    {
+
+    }
+
+    /* vector 는 메모리 재할당 시에
+     * 이동 생성자가 noexcept 인 경우에만 복사 대신 이동을 한다. */
+    Widget(Widget&& rhs) : pimpl(move(rhs.pimpl))
+    {
+
+    }
+};
+
+class DeferredReclaimer
+{
+    struct Disposable
+    {
+        virtual ~Disposable() = default;
+    };
+
+    template <typename C>
+    struct Holder : Disposable
+    {
+        C container;
+
+        explicit Holder(C&& container) : container(move(container)) { }
+    };
+
+    mutex m;
+    condition_variable wake, idle;
+    vector<unique_ptr<Disposable>> pending;
+    bool busy = false;
+    bool stopping = false;
+    thread worker;
+
+    void loop()
+    {
+        unique_lock<mutex> lock(m);
+
+        for (;;)
+        {
+            wake.wait(lock, [&] { return stopping || !pending.empty(); });
+
+            if (pending.empty())
+                return;
+
+            /* 큐를 통째로 가져와 잠금 밖에서 소멸시킨다. */
+            vector<unique_ptr<Disposable>> batch;
+            batch.swap(pending);
+            busy = true;
+
+            lock.unlock();
+            batch.clear();
+            lock.lock();
+
+            busy = false;
+
+            if (pending.empty())
+                idle.notify_all();
+        }
+    }
+
+public:
+    DeferredReclaimer() : worker(&DeferredReclaimer::loop, this) { }
+
+    DeferredReclaimer(const DeferredReclaimer&) = delete;
+    DeferredReclaimer& operator= (const DeferredReclaimer&) = delete;
+
+    /* 남은 것을 모두 소멸시킨 뒤 끝난다. */
+    ~DeferredReclaimer()
+    {
+        {
+            lock_guard<mutex> lock(m);
+            stopping = true;
+        }
+
+        wake.notify_one();
+        worker.join();
+    }
+
+    /* container 는 비워진 상태로 남는다. */
+    template <typename C>
+    void dispose(C&& container)
+    {
+        static_assert(!is_lvalue_reference<C>::value, "dispose(move(container)) 로 넘겨야 한다.");
+
+        unique_ptr<Disposable> box = make_unique<Holder<C>>(move(container));
+
+        {
+            lock_guard<mutex> lock(m);
+            pending.push_back(move(box));
+        }
+
+        wake.notify_one();
+    }
+
+    /* 지금까지 넘긴 것이 모두 소멸될 때까지 기다린다. */
+    void flush()
+    {
+        unique_lock<mutex> lock(m);
+        idle.wait(lock, [&] { return pending.empty() && !busy; });
+    }
+};
+
+template <typename F>
+double measure(F f)
+{
+    steady_clock::time_point start = steady_clock::now();
+    f();
+    steady_clock::time_point end = steady_clock::now();
+
+    return duration<double>(end - start).count();
+}
+
+struct Timing
+{
+    double caller;
+    double background;
+};
+
+template <typename T>
+Timing clear_inline(int n)
+{
+    vector<T> v;
+    for (int i = 0; i < n; ++i)
+        v.push_back(T(i));
+
+    double caller = measure([&] {
+        v.clear();
+        v.shrink_to_fit();
+    });
+
+    return Timing{caller, 0.0};
+}
+
+template <typename T>
+Timing clear_deferred(int n, DeferredReclaimer& reclaimer)
+{
+    vector<T> v;
+    for (int i = 0; i < n; ++i)
+        v.push_back(T(i));
+
+    steady_clock::time_point start = steady_clock::now();
+    reclaimer.dispose(move(v));
+    steady_clock::time_point handed_off = steady_clock::now();
+    reclaimer.flush();
+    steady_clock::time_point reclaimed = steady_clock::now();
+
+    return Timing{duration<double>(handed_off - start).count(), duration<double>(reclaimed - handed_off).count()};
+}
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+template <typename Run>
+void report(const char* label, int reps, Run run)
+{
+    vector<double> backgrounds;
+
+    vector<double> callers = run_bench([&] {
+        Timing t = run();
+        backgrounds.push_back(t.background);
+        return t.caller;
+    }, kWarmup, reps);
+
+    /* 워밍업 실행의 회수 시간은 버린다. */
+    backgrounds.erase(backgrounds.begin(), backgrounds.begin() + kWarmup);
+
+    cout << label << ": 호출 스레드 " << summarize(callers).median << " 초, 회수 스레드 " << summarize(backgrounds).median << " 초" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 3;
+
+    if (reps < 1)
+    {
+        cerr << "반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    DeferredReclaimer reclaimer;
+
+    /* 호출한 스레드가 원소를 모두 소멸시킨다. */
+    report("vw clear", reps, [&] { return clear_inline<WidgetImpl>(n); });
+    report("vpimpl clear", reps, [&] { return clear_inline<Widget>(n); });
+
+    /* 호출한 스레드는 버퍼만 넘기고 돌아온다. (회수 스레드 시간은 flush 까지 기다린 시간) */
+    report("vw dispose", reps, [&] { return clear_deferred<WidgetImpl>(n, reclaimer); });
+    report("vpimpl dispose", reps, [&] { return clear_deferred<Widget>(n, reclaimer); });
+
+    return 0;
+}
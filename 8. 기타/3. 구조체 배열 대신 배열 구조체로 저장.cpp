@@ -0,0 +1,356 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <array>
+#include <algorithm>
+#include <type_traits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 구조체 배열(AoS) 대신 배열 구조체(SoA)로 저장
+ *
+ * vector<WidgetImpl> 와 vector<Widget> 은 모두
+ * i, b, c, d, name, arr 를 한 객체 안에 섞어서 저장한다.
+ *
+ * WidgetStore 는 필드마다 별도의 연속 배열(열)에 저장한다.
+ * - 재할당 시에 트리비얼하게 복사 가능한 열은 memcpy 한 번으로 옮긴다.
+ * - 필드별로 복사/이동 생성자를 부를 필요가 없다.
+ * - name 열만 string 이므로 vector<string> 으로 두고, noexcept 이동으로 옮긴다.
+ * - b, c, d 만 훑는 순회는 필요한 열만 캐시로 가져온다.
+ *
+ * 원소 하나를 다룰 때는 각 열의 참조를 묶은 행 프록시를 사용한다.
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+    friend class Widget;
+    friend class WidgetStore;
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    WidgetImpl(const WidgetImpl& rhs)
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name)
+    {
+
+    }
+
+    /* noexcept 이 아니기 때문에 메모리 재할당 시에는 복사 생성이 사용된다. */
+    WidgetImpl(WidgetImpl&& rhs)
+        : i(move(rhs.i)), b(move(rhs.b)), c(move(rhs.c)), d(move(rhs.d)), name(move(rhs.name))
+    {
+
+    }
+
+    double sum() const { return b + c + d; }
+};
+
+class Widget
+{
+    unique_ptr<WidgetImpl> pimpl;
+
+public:
+    Widget(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : pimpl(make_unique<WidgetImpl>(i, b, c, d, name))
+    {
+
+    }
+
+    Widget(Widget&& rhs) : pimpl(move(rhs.pimpl))
+    {
+
+    }
+
+    double sum() const { return pimpl->sum(); }
+};
+
+/* 트리비얼하게 복사 가능한 타입의 열: 재할당은 memcpy 한 번 */
+template <typename T>
+class PodColumn
+{
+    static_assert(is_trivially_copyable<T>::value, "PodColumn 은 트리비얼하게 복사 가능한 타입만 담는다.");
+
+    T* data = nullptr;
+
+public:
+    PodColumn() = default;
+    PodColumn(const PodColumn&) = delete;
+    PodColumn& operator= (const PodColumn&) = delete;
+
+    ~PodColumn() { free(data); }
+
+    void relocate(size_t size, size_t new_capacity)
+    {
+        T* fresh = static_cast<T*>(malloc(new_capacity * sizeof(T)));
+
+        if (fresh == nullptr)
+            throw bad_alloc();
+
+        if (size > 0)
+            memcpy(fresh, data, size * sizeof(T));
+
+        free(data);
+        data = fresh;
+    }
+
+    T& operator[] (size_t idx) { return data[idx]; }
+    const T& operator[] (size_t idx) const { return data[idx]; }
+};
+
+class WidgetStore
+{
+    size_t count = 0;
+    size_t cap = 0;
+
+    PodColumn<int> i;
+    PodColumn<double> b, c, d;
+    PodColumn<array<double, 10>> arr;
+    vector<string> name;
+
+    void grow()
+    {
+        size_t new_cap = cap == 0 ? 1 : cap * 2;
+
+        i.relocate(count, new_cap);
+        b.relocate(count, new_cap);
+        c.relocate(count, new_cap);
+        d.relocate(count, new_cap);
+        arr.relocate(count, new_cap);
+        name.reserve(new_cap);
+
+        cap = new_cap;
+    }
+
+public:
+    /* 한 행의 각 필드를 가리키는 프록시 */
+    struct Row
+    {
+        int& i;
+        double& b;
+        double& c;
+        double& d;
+        string& name;
+        array<double, 10>& arr;
+
+        double sum() const { return b + c + d; }
+    };
+
+    void emplace_back(int i_ = 0, double b_ = 0.0, double c_ = 0.0, double d_ = 0.0, string name_ = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    {
+        if (count == cap)
+            grow();
+
+        /* 예외가 날 수 있는 name 을 먼저 넣어야 열 사이의 크기가 어긋나지 않는다. */
+        name.push_back(move(name_));
+
+        i[count] = i_;
+        b[count] = b_;
+        c[count] = c_;
+        d[count] = d_;
+        arr[count] = array<double, 10>{};
+
+        ++count;
+    }
+
+    void push_back(const WidgetImpl& w)
+    {
+        emplace_back(w.i, w.b, w.c, w.d, w.name);
+    }
+
+    Row operator[] (size_t idx)
+    {
+        return Row{i[idx], b[idx], c[idx], d[idx], name[idx], arr[idx]};
+    }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return cap; }
+
+    /* b, c, d 열만 순회한다. */
+    double sum() const
+    {
+        double total = 0.0;
+
+        for (size_t k = 0; k < count; ++k)
+            total += b[k] + c[k] + d[k];
+
+        return total;
+    }
+};
+
+template <typename F>
+double measure(F f)
+{
+    steady_clock::time_point start = steady_clock::now();
+    f();
+    steady_clock::time_point end = steady_clock::now();
+
+    return duration<double>(end - start).count();
+}
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+template <typename W>
+double traverse(const vector<W>& v)
+{
+    double total = 0.0;
+
+    for (const W& w : v)
+        total += w.sum();
+
+    return total;
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 5;
+    double sink = 0.0;
+
+    if (reps < 1)
+    {
+        cerr << "반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    WidgetStore store;
+    store.emplace_back(1);
+    store.push_back(WidgetImpl(2, 0.5));
+
+    WidgetStore::Row row = store[1];
+    row.c = 1.5;
+    cout << "store[1]: i = " << row.i << ", sum = " << row.sum() << ", name = " << row.name << endl;
+
+    /* 삽입과 순회를 따로 반복해서 각각의 중앙값을 구한다. */
+
+    /* 데이터 멤버를 직접 복사하는 버전 */
+    double vw_build = summarize(run_bench([&] {
+        vector<WidgetImpl> vw;
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                vw.push_back(WidgetImpl(i));
+        });
+    }, kWarmup, reps)).median;
+
+    vector<WidgetImpl> vw;
+    for (int i = 0; i < n; ++i)
+        vw.push_back(WidgetImpl(i));
+    double vw_scan = summarize(run_bench([&] { return measure([&] { sink += traverse(vw); }); }, kWarmup, reps)).median;
+    vw.clear();
+    vw.shrink_to_fit();
+
+    /* Pimpl 포인터만 이동하는 버전 */
+    double vpimpl_build = summarize(run_bench([&] {
+        vector<Widget> vpimpl;
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                vpimpl.push_back(Widget(i));
+        });
+    }, kWarmup, reps)).median;
+
+    vector<Widget> vpimpl;
+    for (int i = 0; i < n; ++i)
+        vpimpl.push_back(Widget(i));
+    double vpimpl_scan = summarize(run_bench([&] { return measure([&] { sink += traverse(vpimpl); }); }, kWarmup, reps)).median;
+    vpimpl.clear();
+    vpimpl.shrink_to_fit();
+
+    /* 열마다 memcpy 로 옮기는 버전 */
+    double store_build = summarize(run_bench([&] {
+        WidgetStore ws;
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                ws.emplace_back(i);
+        });
+    }, kWarmup, reps)).median;
+
+    WidgetStore ws;
+    for (int i = 0; i < n; ++i)
+        ws.emplace_back(i);
+    double store_scan = summarize(run_bench([&] { return measure([&] { sink += ws.sum(); }); }, kWarmup, reps)).median;
+
+    cout << "vw 삽입: " << vw_build << " 초, b+c+d 순회: " << vw_scan << " 초" << endl;
+    cout << "vpimpl 삽입: " << vpimpl_build << " 초, b+c+d 순회: " << vpimpl_scan << " 초" << endl;
+    cout << "WidgetStore 삽입: " << store_build << " 초, b+c+d 순회: " << store_scan << " 초" << endl;
+    cout << "체크섬: " << sink << endl;
+
+    return 0;
+}
@@ -0,0 +1,297 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 재할당 없이 주소가 고정되는 분할(segmented) vector
+ *
+ * vector 는 용량이 부족하면 새 버퍼를 할당하고 모든 원소를 복사/이동한다.
+ * - 재할당하는 순간에는 원본과 새 버퍼가 동시에 존재하므로 메모리가 2배로 튄다.
+ * - 원소의 주소가 바뀌므로 포인터/참조가 무효화된다.
+ *
+ * SegmentedVector 는 블록을 2배씩 커지는 크기로 추가만 한다.
+ * - 블록 k 의 크기는 First << k 이다.
+ * - 기존 원소는 절대 옮기지 않으므로 복사/이동이 없고 주소도 바뀌지 않는다.
+ * - 인덱싱은 (idx + First) 의 최상위 비트 위치로 블록을 찾으므로 O(1) 이다.
+ *
+ *   idx + First = 2^h + offset 이면
+ *   블록 번호 = h - log2(First), 블록 내 위치 = offset
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+    friend class Widget;
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    WidgetImpl(const WidgetImpl& rhs)
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name)
+    {
+
+    }
+
+    /* noexcept 이 아니기 때문에 메모리 재할당 시에는 복사 생성이 사용된다. */
+    WidgetImpl(WidgetImpl&& rhs)
+        : i(move(rhs.i)), b(move(rhs.b)), c(move(rhs.c)), d(move(rhs.d)), name(move(rhs.name))
+    {
+
+    }
+
+    int id() const { return i; }
+};
+
+class Widget
+{
+    unique_ptr<WidgetImpl> pimpl;
+
+public:
+    Widget(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : pimpl(make_unique<WidgetImpl>(i, b, c, d, name))
+    {
+
+    }
+
+    Widget(Widget&& rhs) : pimpl(move(rhs.pimpl))
+    {
+
+    }
+};
+
+template <typename T, size_t First = 16>
+class SegmentedVector
+{
+    static_assert(First > 0 && (First & (First - 1)) == 0, "First 는 2의 거듭제곱이어야 한다.");
+
+    static constexpr size_t kMaxBlocks = 64;
+
+    T* blocks[kMaxBlocks] = {};
+    size_t count = 0;
+    size_t block_count = 0;
+
+    static constexpr int log2_of(size_t x) { return x == 1 ? 0 : 1 + log2_of(x >> 1); }
+
+    static constexpr int kFirstShift = log2_of(First);
+
+    /* 최상위 비트 위치 (GCC/Clang 내장 함수) */
+    static int high_bit(size_t x) { return 63 - __builtin_clzll(x); }
+
+    static pair<size_t, size_t> locate(size_t idx)
+    {
+        size_t biased = idx + First;
+        int h = high_bit(biased);
+
+        return { h - kFirstShift, biased - (size_t(1) << h) };
+    }
+
+    static size_t block_size(size_t block) { return First << block; }
+
+public:
+    SegmentedVector() = default;
+    SegmentedVector(const SegmentedVector&) = delete;
+    SegmentedVector& operator= (const SegmentedVector&) = delete;
+
+    ~SegmentedVector()
+    {
+        clear();
+
+        for (size_t k = 0; k < block_count; ++k)
+            ::operator delete(blocks[k]);
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        pair<size_t, size_t> pos = locate(count);
+
+        /* 새 블록만 추가할 뿐, 기존 블록은 건드리지 않는다. */
+        if (pos.first == block_count)
+        {
+            blocks[block_count] = static_cast<T*>(::operator new(block_size(block_count) * sizeof(T)));
+            ++block_count;
+        }
+
+        T* p = new (blocks[pos.first] + pos.second) T(forward<Args>(args)...);
+        ++count;
+
+        return *p;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(move(value)); }
+
+    T& operator[] (size_t idx)
+    {
+        pair<size_t, size_t> pos = locate(idx);
+
+        return blocks[pos.first][pos.second];
+    }
+
+    const T& operator[] (size_t idx) const
+    {
+        pair<size_t, size_t> pos = locate(idx);
+
+        return blocks[pos.first][pos.second];
+    }
+
+    /* 블록은 남겨 두고 원소만 소멸시킨다. */
+    void clear()
+    {
+        for (size_t idx = 0; idx < count; ++idx)
+            (*this)[idx].~T();
+
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+};
+
+template <typename F>
+double measure(F f)
+{
+    steady_clock::time_point start = steady_clock::now();
+    f();
+    steady_clock::time_point end = steady_clock::now();
+
+    return duration<double>(end - start).count();
+}
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 5;
+
+    if (reps < 1)
+    {
+        cerr << "반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    /* 원소를 계속 추가해도 첫 원소의 주소는 그대로다. */
+    {
+        SegmentedVector<WidgetImpl> sv;
+        sv.push_back(WidgetImpl(0));
+        WidgetImpl* first = &sv[0];
+
+        for (int i = 1; i < 1000; ++i)
+            sv.push_back(WidgetImpl(i));
+
+        cout << "주소 유지: " << boolalpha << (first == &sv[0]) << ", sv[999] = " << sv[999].id() << endl;
+    }
+
+    /* 데이터 멤버를 직접 복사하는 버전 */
+    double vw_time = summarize(run_bench([&] {
+        vector<WidgetImpl> vw;
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                vw.push_back(WidgetImpl(i));
+        });
+    }, kWarmup, reps)).median;
+
+    /* Pimpl 포인터만 이동하는 버전 */
+    double vpimpl_time = summarize(run_bench([&] {
+        vector<Widget> vpimpl;
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                vpimpl.push_back(Widget(i));
+        });
+    }, kWarmup, reps)).median;
+
+    /* 블록만 추가하고 원소는 옮기지 않는 버전 */
+    double segmented_time = summarize(run_bench([&] {
+        SegmentedVector<WidgetImpl> sv;
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                sv.push_back(WidgetImpl(i));
+        });
+    }, kWarmup, reps)).median;
+
+    cout << "vw: " << vw_time << " 초" << endl;
+    cout << "vpimpl: " << vpimpl_time << " 초" << endl;
+    cout << "SegmentedVector: " << segmented_time << " 초" << endl;
+
+    return 0;
+}
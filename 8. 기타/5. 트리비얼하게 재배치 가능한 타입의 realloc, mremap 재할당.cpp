@@ -0,0 +1,340 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 트리비얼하게 재배치(relocate) 가능한 타입의 realloc, mremap 재할당
+ *
+ * "이동 생성 + 원본 소멸" 이 "바이트 복사 후 원본을 잊는 것" 과 같은 타입은
+ * 재할당 시에 원소별 복사/이동 없이 메모리를 통째로 옮겨도 된다.
+ * - int, double, 힙 버퍼를 가리키는 포인터 등이 그렇다.
+ * - 컴파일러가 알아낼 수 없으므로 is_relocatable 특성으로 직접 표시(opt-in)한다.
+ *
+ * 주의: libstdc++ 의 string 은 SSO 버퍼를 가리키는 포인터를 자기 안에 두므로
+ * 바이트 복사로 옮기면 깨진다. 그래서 여기서는 name 을
+ * 힙 버퍼 포인터만 들고 있는 Name 타입으로 바꿨다.
+ *
+ * RelocVector
+ * - 작은 버퍼는 realloc 으로 늘린다. (제자리 확장이 되면 복사조차 없다.)
+ * - 큰 버퍼는 mmap 으로 잡고 mremap 으로 늘린다. (리눅스)
+ *   페이지 내용을 복사하지 않고 페이지 테이블만 옮기므로 거의 상수 시간이다.
+ */
+
+template <typename T>
+struct is_relocatable : is_trivially_copyable<T> { };
+
+/* 힙에 할당된 문자열: 포인터 하나와 길이뿐이므로 재배치 가능하다. */
+class Name
+{
+    unique_ptr<char[]> buf;
+    size_t len = 0;
+
+public:
+    Name(const char* s = "")
+    : buf(new char[strlen(s) + 1]), len(strlen(s))
+    {
+        memcpy(buf.get(), s, len + 1);
+    }
+
+    Name(const Name& rhs) : Name(rhs.c_str()) { }
+
+    Name(Name&& rhs) noexcept = default;
+
+    Name& operator= (const Name& rhs)
+    {
+        Name tmp(rhs);
+        swap(buf, tmp.buf);
+        swap(len, tmp.len);
+
+        return *this;
+    }
+
+    const char* c_str() const { return buf.get(); }
+    size_t size() const { return len; }
+};
+
+template <>
+struct is_relocatable<Name> : true_type { };
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    Name name;
+    double arr[10];
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, const char* name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    WidgetImpl(const WidgetImpl& rhs)
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name)
+    {
+
+    }
+
+    /* noexcept 이 아니기 때문에 vector 의 메모리 재할당 시에는 복사 생성이 사용된다. */
+    WidgetImpl(WidgetImpl&& rhs)
+        : i(move(rhs.i)), b(move(rhs.b)), c(move(rhs.c)), d(move(rhs.d)), name(move(rhs.name))
+    {
+
+    }
+
+    int id() const { return i; }
+    const char* label() const { return name.c_str(); }
+};
+
+/* 모든 멤버가 재배치 가능하므로 WidgetImpl 도 재배치 가능하다고 표시한다. */
+template <>
+struct is_relocatable<WidgetImpl> : true_type { };
+
+template <typename T>
+class RelocVector
+{
+    static_assert(is_relocatable<T>::value, "RelocVector 는 재배치 가능한 타입만 담는다.");
+
+    /* 이 크기 이상이면 mmap/mremap 을 사용한다. */
+    static constexpr size_t kMapThreshold = 1 << 20;
+
+    T* data = nullptr;
+    size_t count = 0;
+    size_t cap = 0;
+    size_t mapped_bytes = 0;    // 0 이면 malloc 버퍼
+
+    static size_t page_round(size_t bytes)
+    {
+#ifdef __linux__
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return (bytes + page - 1) / page * page;
+#else
+        return bytes;
+#endif
+    }
+
+    void grow()
+    {
+        size_t new_cap = cap == 0 ? 16 : cap * 2;
+        size_t new_bytes = new_cap * sizeof(T);
+
+#ifdef __linux__
+        if (new_bytes >= kMapThreshold)
+        {
+            new_bytes = page_round(new_bytes);
+            void* p;
+
+            if (mapped_bytes != 0)
+            {
+                /* 페이지를 복사하지 않고 가상 주소만 다시 매핑한다. */
+                p = mremap(data, mapped_bytes, new_bytes, MREMAP_MAYMOVE);
+            }
+            else
+            {
+                p = mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+                if (p != MAP_FAILED)
+                {
+                    memcpy(p, data, count * sizeof(T));
+                    free(data);
+                }
+            }
+
+            if (p == MAP_FAILED)
+                throw bad_alloc();
+
+            data = static_cast<T*>(p);
+            mapped_bytes = new_bytes;
+            cap = new_bytes / sizeof(T);
+
+            return;
+        }
+#endif
+
+        void* p = realloc(static_cast<void*>(data), new_bytes);
+
+        if (p == nullptr)
+            throw bad_alloc();
+
+        data = static_cast<T*>(p);
+        cap = new_cap;
+    }
+
+public:
+    RelocVector() = default;
+    RelocVector(const RelocVector&) = delete;
+    RelocVector& operator= (const RelocVector&) = delete;
+
+    ~RelocVector()
+    {
+        for (size_t idx = 0; idx < count; ++idx)
+            data[idx].~T();
+
+#ifdef __linux__
+        if (mapped_bytes != 0)
+        {
+            munmap(data, mapped_bytes);
+            return;
+        }
+#endif
+        free(data);
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        /* 인자가 자기 원소를 가리킬 수 있으므로 먼저 만들어 두고 옮긴다. */
+        if (count == cap)
+        {
+            T tmp(forward<Args>(args)...);
+            grow();
+            return *new (data + count++) T(move(tmp));
+        }
+
+        return *new (data + count++) T(forward<Args>(args)...);
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(move(value)); }
+
+    T& operator[] (size_t idx) { return data[idx]; }
+    const T& operator[] (size_t idx) const { return data[idx]; }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return cap; }
+};
+
+template <typename F>
+double measure(F f)
+{
+    steady_clock::time_point start = steady_clock::now();
+    f();
+    steady_clock::time_point end = steady_clock::now();
+
+    return duration<double>(end - start).count();
+}
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 5;
+
+    if (reps < 1)
+    {
+        cerr << "반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    {
+        RelocVector<WidgetImpl> rv;
+
+        for (int i = 0; i < 100000; ++i)
+            rv.push_back(WidgetImpl(i));
+
+        cout << "rv[99999] = " << rv[99999].id() << ", " << rv[99999].label() << endl;
+    }
+
+    /* 재할당 시에 원소마다 복사 생성하는 버전 */
+    double vw_time = summarize(run_bench([&] {
+        vector<WidgetImpl> vw;
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                vw.push_back(WidgetImpl(i));
+        });
+    }, kWarmup, reps)).median;
+
+    /* 재할당 시에 realloc/mremap 으로 메모리를 통째로 옮기는 버전 */
+    double reloc_time = summarize(run_bench([&] {
+        RelocVector<WidgetImpl> rv;
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                rv.push_back(WidgetImpl(i));
+        });
+    }, kWarmup, reps)).median;
+
+    cout << "vw: " << vw_time << " 초" << endl;
+    cout << "RelocVector: " << reloc_time << " 초" << endl;
+
+    return 0;
+}
@@ -0,0 +1,295 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 가상 주소를 예약하고 필요할 때 커밋하는 vector
+ *
+ * 원소 개수의 상한을 알고 있다면
+ * - 처음에 mmap(PROT_NONE) 으로 상한만큼의 가상 주소 공간만 예약한다.
+ *   (물리 메모리는 쓰지 않는다.)
+ * - push_back 이 커밋된 영역의 끝을 넘을 때마다
+ *   mprotect 로 다음 페이지 묶음을 읽기/쓰기 가능하게 커밋한다.
+ *
+ * 버퍼가 절대 움직이지 않으므로
+ * - 재할당도, 원소 복사/이동도 없다.
+ * - 원소 주소가 고정된다.
+ * - 상주 메모리는 원소 수에 비례해 선형적으로 늘어난다.
+ *
+ * Pimpl 처럼 원소마다 힙 할당을 하지 않고도
+ * "메모리 사용량이 선형적으로 증가" 한다.
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+    friend class Widget;
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    WidgetImpl(const WidgetImpl& rhs)
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name)
+    {
+
+    }
+
+    /* noexcept 이 아니기 때문에 메모리 재할당 시에는 복사 생성이 사용된다. */
+    WidgetImpl(WidgetImpl&& rhs)
+        : i(move(rhs.i)), b(move(rhs.b)), c(move(rhs.c)), d(move(rhs.d)), name(move(rhs.name))
+    {
+
+    }
+
+    int id() const { return i; }
+};
+
+class Widget
+{
+    unique_ptr<WidgetImpl> pimpl;
+
+public:
+    Widget(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : pimpl(make_unique<WidgetImpl>(i, b, c, d, name))
+    {
+
+    }
+
+    Widget(Widget&& rhs) : pimpl(move(rhs.pimpl))
+    {
+
+    }
+};
+
+template <typename T>
+class ReservedVector
+{
+    /* 한 번에 커밋할 페이지 수: mprotect 호출 횟수와 과잉 커밋 사이의 절충 */
+    static constexpr size_t kCommitPages = 16;
+
+    T* data = nullptr;
+    size_t count = 0;
+    size_t max_count = 0;
+    size_t reserved_bytes = 0;
+    size_t committed_bytes = 0;
+    size_t commit_chunk = 0;
+
+    void commit_more()
+    {
+        size_t new_committed = min(committed_bytes + commit_chunk, reserved_bytes);
+
+        if (mprotect(reinterpret_cast<char*>(data) + committed_bytes,
+                     new_committed - committed_bytes, PROT_READ | PROT_WRITE) != 0)
+            throw bad_alloc();
+
+        committed_bytes = new_committed;
+    }
+
+public:
+    explicit ReservedVector(size_t max_elements) : max_count(max_elements)
+    {
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+        commit_chunk = page * kCommitPages;
+        reserved_bytes = max(size_t(1), (max_elements * sizeof(T) + page - 1) / page) * page;
+
+        /* 주소 공간만 예약한다: 접근 불가, 스왑 예약 없음 */
+        void* p = mmap(nullptr, reserved_bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+        if (p == MAP_FAILED)
+            throw bad_alloc();
+
+        data = static_cast<T*>(p);
+    }
+
+    ReservedVector(const ReservedVector&) = delete;
+    ReservedVector& operator= (const ReservedVector&) = delete;
+
+    ~ReservedVector()
+    {
+        for (size_t idx = 0; idx < count; ++idx)
+            data[idx].~T();
+
+        munmap(data, reserved_bytes);
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (count == max_count)
+            throw length_error("ReservedVector: 예약한 원소 수를 넘었다.");
+
+        /* 새 원소의 끝이 커밋된 영역을 넘으면 다음 묶음을 커밋한다. */
+        while ((count + 1) * sizeof(T) > committed_bytes)
+            commit_more();
+
+        T* p = new (data + count) T(forward<Args>(args)...);
+        ++count;
+
+        return *p;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(move(value)); }
+
+    T& operator[] (size_t idx) { return data[idx]; }
+    const T& operator[] (size_t idx) const { return data[idx]; }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return max_count; }
+    size_t committed() const { return committed_bytes; }
+};
+
+template <typename F>
+double measure(F f)
+{
+    steady_clock::time_point start = steady_clock::now();
+    f();
+    steady_clock::time_point end = steady_clock::now();
+
+    return duration<double>(end - start).count();
+}
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 5;
+
+    if (reps < 1)
+    {
+        cerr << "반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    /* 커밋된 크기는 원소 수에 비례해서 늘어난다. */
+    {
+        ReservedVector<WidgetImpl> rv(n);
+        int step = max(n / 4, 1);
+
+        for (int i = 0; i < n; ++i)
+        {
+            rv.push_back(WidgetImpl(i));
+
+            if ((i + 1) % step == 0)
+                cout << "size: " << rv.size() << ", 커밋: " << rv.committed() / 1024 << " KiB" << endl;
+        }
+    }
+
+    /* 데이터 멤버를 직접 복사하는 버전 */
+    double vw_time = summarize(run_bench([&] {
+        vector<WidgetImpl> vw;
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                vw.push_back(WidgetImpl(i));
+        });
+    }, kWarmup, reps)).median;
+
+    /* Pimpl 포인터만 이동하는 버전 */
+    double vpimpl_time = summarize(run_bench([&] {
+        vector<Widget> vpimpl;
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                vpimpl.push_back(Widget(i));
+        });
+    }, kWarmup, reps)).median;
+
+    /* 예약해 둔 주소 공간에 커밋만 하는 버전 */
+    double reserved_time = summarize(run_bench([&] {
+        ReservedVector<WidgetImpl> rv(n);
+        return measure([&] {
+            for (int i = 0; i < n; ++i)
+                rv.push_back(WidgetImpl(i));
+        });
+    }, kWarmup, reps)).median;
+
+    cout << "vw: " << vw_time << " 초" << endl;
+    cout << "vpimpl: " << vpimpl_time << " 초" << endl;
+    cout << "ReservedVector: " << reserved_time << " 초" << endl;
+
+    return 0;
+}
@@ -0,0 +1,215 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * push_back 지연 시간 히스토그램
+ *
+ * 총 소요 시간만 보면 재할당 비용이 평균에 묻힌다.
+ * 실제로 문제가 되는 것은 재할당이 일어나서
+ * 수백만 개의 WidgetImpl 을 복사하는 단 한 번의 push_back 이다.
+ *
+ * push_back 마다 시각을 재서 로그 구간 히스토그램(HDR 방식)에 기록한다.
+ * - 2의 거듭제곱 구간마다 16 개의 하위 구간을 두므로 상대 오차가 1/16 이내다.
+ * - 구간 수가 고정(약 8KB)이므로 기록은 배열 원소 하나를 증가시키는 것뿐이다.
+ * - 용량이 바뀐(재할당이 일어난) 샘플은 따로 표시해 별도 히스토그램에도 넣는다.
+ *
+ * steady_clock::now() 두 번의 비용(수십 ns)이 측정값에 더해지므로
+ * p50 은 대략 그만큼 부풀려져 있다.
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+    friend class Widget;
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    WidgetImpl(const WidgetImpl& rhs)
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name)
+    {
+
+    }
+
+    /* noexcept 이 아니기 때문에 메모리 재할당 시에는 복사 생성이 사용된다. */
+    WidgetImpl(WidgetImpl&& rhs)
+        : i(move(rhs.i)), b(move(rhs.b)), c(move(rhs.c)), d(move(rhs.d)), name(move(rhs.name))
+    {
+
+    }
+};
+
+class Widget
+{
+    unique_ptr<WidgetImpl> pimpl;
+
+public:
+    Widget(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : pimpl(make_unique<WidgetImpl>(i, b, c, d, name))
+    {
+
+    }
+
+    /* vector 는 메모리 재할당 시에
+     * 이동 생성자가 noexcept 인 경우에만 복사 대신 이동을 한다. */
+    Widget(Widget&& rhs) : pimpl(move(rhs.pimpl))
+    {
+
+    }
+};
+
+class LogHistogram
+{
+    static constexpr int kSubBits = 4;
+    static constexpr uint64_t kSub = uint64_t(1) << kSubBits;
+    static constexpr size_t kBuckets = (64 - kSubBits + 1) * kSub;
+
+    uint64_t counts[kBuckets] = {};
+    uint64_t total = 0;
+    uint64_t max_value = 0;
+
+    static size_t index_of(uint64_t v)
+    {
+        if (v < kSub)
+            return static_cast<size_t>(v);
+
+        int h = 63 - __builtin_clzll(v);
+        int shift = h - kSubBits;
+
+        return static_cast<size_t>(shift) * kSub + static_cast<size_t>(v >> shift);
+    }
+
+    /* 구간의 상한 */
+    static uint64_t upper_of(size_t idx)
+    {
+        if (idx < 2 * kSub)
+            return idx;
+
+        int shift = static_cast<int>(idx / kSub) - 1;
+        uint64_t sub = idx % kSub + kSub;
+
+        return ((sub + 1) << shift) - 1;
+    }
+
+public:
+    void record(uint64_t v)
+    {
+        ++counts[index_of(v)];
+        ++total;
+
+        if (v > max_value)
+            max_value = v;
+    }
+
+    uint64_t percentile(double p) const
+    {
+        if (total == 0)
+            return 0;
+
+        uint64_t target = static_cast<uint64_t>(p * total);
+        if (target == 0)
+            target = 1;
+
+        uint64_t seen = 0;
+
+        for (size_t idx = 0; idx < kBuckets; ++idx)
+        {
+            seen += counts[idx];
+
+            if (seen >= target)
+                return min(upper_of(idx), max_value);
+        }
+
+        return max_value;
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t max() const { return max_value; }
+};
+
+struct LatencyReport
+{
+    LogHistogram all;
+    LogHistogram realloc_only;     // 용량이 바뀐 push_back 만
+};
+
+/* push_back 하나하나의 시간을 재고, 용량이 바뀌었는지 함께 기록한다. */
+template <typename T>
+void record_push_back(int n, LatencyReport& report)
+{
+    vector<T> v;
+
+    for (int i = 0; i < n; ++i)
+    {
+        size_t cap = v.capacity();
+
+        steady_clock::time_point start = steady_clock::now();
+        v.push_back(T(i));
+        steady_clock::time_point end = steady_clock::now();
+
+        uint64_t ns = static_cast<uint64_t>(duration_cast<nanoseconds>(end - start).count());
+
+        report.all.record(ns);
+
+        if (v.capacity() != cap)
+            report.realloc_only.record(ns);
+    }
+}
+
+void print(const char* label, const LogHistogram& h)
+{
+    cout << label << " (" << h.count() << " 회)"
+         << ": p50 " << h.percentile(0.5) << " ns"
+         << ", p99 " << h.percentile(0.99) << " ns"
+         << ", p99.9 " << h.percentile(0.999) << " ns"
+         << ", max " << h.max() << " ns" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+
+    /* 히스토그램이 8KB 정도이므로 스택 대신 힙에 둔다. */
+    unique_ptr<LatencyReport> vw_report = make_unique<LatencyReport>();
+    unique_ptr<LatencyReport> vpimpl_report = make_unique<LatencyReport>();
+
+    /*
+     * 데이터 멤버를 직접 복사하는 버전
+     *
+     * 재할당이 일어난 push_back 의 max 가
+     * 원소 수에 비례해서 커진다.
+     */
+    record_push_back<WidgetImpl>(n, *vw_report);
+
+    /*
+     * Pimpl 포인터만 이동하는 버전
+     *
+     * 재할당 시에도 포인터만 옮기므로
+     * 꼬리 지연 시간이 훨씬 작다.
+     */
+    record_push_back<Widget>(n, *vpimpl_report);
+
+    print("vw 전체", vw_report->all);
+    print("vw 재할당", vw_report->realloc_only);
+    print("vpimpl 전체", vpimpl_report->all);
+    print("vpimpl 재할당", vpimpl_report->realloc_only);
+
+    return 0;
+}
@@ -0,0 +1,303 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 점진적(분할 상환) 재할당 vector
+ *
+ * noexcept 이동을 쓰더라도 vector 는 용량이 부족해지는 순간
+ * 한 번의 push_back 안에서 모든 원소를 새 버퍼로 옮긴다.
+ * - 원소가 2백만 개를 넘으면 그 push_back 하나가 O(n) 만큼 멈춘다.
+ *
+ * 해시 테이블의 점진적 rehash 처럼
+ * - 용량이 부족하면 새 버퍼만 할당하고, 기존 원소는 옛 버퍼에 그대로 둔다.
+ * - 이후 push_back 마다 옛 버퍼의 원소를 kMigrateStep 개씩 새 버퍼로 옮긴다.
+ * - 인덱싱은 아직 옮겨지지 않은 구간이면 옛 버퍼를, 아니면 새 버퍼를 본다.
+ *
+ * 다음 재할당까지 cap 번의 push_back 이 남아 있고 옮길 원소도 cap 개이므로
+ * 한 번에 하나 이상씩만 옮기면 다음 재할당 전에 반드시 끝난다.
+ *
+ * 대신
+ * - 옮기는 동안에는 두 버퍼가 함께 존재하므로 최대 메모리 사용량은 vector 와 같고, 그 기간이 더 길다.
+ * - 원소를 하나씩 옮기므로 강한 예외 보장은 하지 않는다.
+ * - 옛 버퍼의 해제(큰 버퍼라면 munmap)는 여전히 한 번에 일어나므로 max 가 0 이 되지는 않는다.
+ */
+
+class WidgetImpl
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+public:
+    WidgetImpl(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+
+    WidgetImpl(const WidgetImpl& rhs)
+    : i(rhs.i), b(rhs.b), c(rhs.c), d(rhs.d), name(rhs.name)
+    {
+
+    }
+
+    /* noexcept 이동 생성자: vector 도 재할당 시에 복사 대신 이동한다. */
+    WidgetImpl(WidgetImpl&& rhs) noexcept
+        : i(move(rhs.i)), b(move(rhs.b)), c(move(rhs.c)), d(move(rhs.d)), name(move(rhs.name))
+    {
+
+    }
+
+    int id() const { return i; }
+};
+
+template <typename T>
+class IncrementalVector
+{
+    static constexpr size_t kMigrateStep = 2;
+
+    T* buf = nullptr;           // 새 버퍼
+    size_t count = 0;
+    size_t cap = 0;
+
+    T* old_buf = nullptr;       // 옮기는 중인 옛 버퍼
+    size_t old_count = 0;       // 옛 버퍼에 있던 원소 수
+    size_t migrated = 0;        // [0, migrated) 는 이미 새 버퍼로 옮겨졌다.
+
+    bool migrating() const { return old_buf != nullptr; }
+
+    void migrate(size_t step)
+    {
+        size_t end = min(migrated + step, old_count);
+
+        for (; migrated < end; ++migrated)
+        {
+            new (buf + migrated) T(move(old_buf[migrated]));
+            old_buf[migrated].~T();
+        }
+
+        if (migrated == old_count)
+        {
+            ::operator delete(old_buf);
+            old_buf = nullptr;
+        }
+    }
+
+    /* 새 버퍼만 할당하고, 기존 원소는 옛 버퍼에 남긴다. */
+    void grow()
+    {
+        if (migrating())
+            migrate(old_count);
+
+        size_t new_cap = cap == 0 ? 16 : cap * 2;
+        T* fresh = static_cast<T*>(::operator new(new_cap * sizeof(T)));
+
+        if (count == 0)
+            ::operator delete(buf);
+        else
+        {
+            old_buf = buf;
+            old_count = count;
+            migrated = 0;
+        }
+
+        buf = fresh;
+        cap = new_cap;
+    }
+
+public:
+    IncrementalVector() = default;
+    IncrementalVector(const IncrementalVector&) = delete;
+    IncrementalVector& operator= (const IncrementalVector&) = delete;
+
+    ~IncrementalVector()
+    {
+        for (size_t idx = 0; idx < count; ++idx)
+            (*this)[idx].~T();
+
+        ::operator delete(old_buf);
+        ::operator delete(buf);
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (count == cap)
+            grow();
+
+        /* 새 원소는 항상 새 버퍼의 제자리에 만든다. */
+        T* p = new (buf + count) T(forward<Args>(args)...);
+        ++count;
+
+        if (migrating())
+            migrate(kMigrateStep);
+
+        return *p;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(move(value)); }
+
+    T& operator[] (size_t idx)
+    {
+        if (migrating() && idx >= migrated && idx < old_count)
+            return old_buf[idx];
+
+        return buf[idx];
+    }
+
+    const T& operator[] (size_t idx) const
+    {
+        if (migrating() && idx >= migrated && idx < old_count)
+            return old_buf[idx];
+
+        return buf[idx];
+    }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return cap; }
+};
+
+class LogHistogram
+{
+    static constexpr int kSubBits = 4;
+    static constexpr uint64_t kSub = uint64_t(1) << kSubBits;
+    static constexpr size_t kBuckets = (64 - kSubBits + 1) * kSub;
+
+    uint64_t counts[kBuckets] = {};
+    uint64_t total = 0;
+    uint64_t max_value = 0;
+
+    static size_t index_of(uint64_t v)
+    {
+        if (v < kSub)
+            return static_cast<size_t>(v);
+
+        int h = 63 - __builtin_clzll(v);
+        int shift = h - kSubBits;
+
+        return static_cast<size_t>(shift) * kSub + static_cast<size_t>(v >> shift);
+    }
+
+    /* 구간의 상한 */
+    static uint64_t upper_of(size_t idx)
+    {
+        if (idx < 2 * kSub)
+            return idx;
+
+        int shift = static_cast<int>(idx / kSub) - 1;
+        uint64_t sub = idx % kSub + kSub;
+
+        return ((sub + 1) << shift) - 1;
+    }
+
+public:
+    void record(uint64_t v)
+    {
+        ++counts[index_of(v)];
+        ++total;
+
+        if (v > max_value)
+            max_value = v;
+    }
+
+    uint64_t percentile(double p) const
+    {
+        if (total == 0)
+            return 0;
+
+        uint64_t target = static_cast<uint64_t>(p * total);
+        if (target == 0)
+            target = 1;
+
+        uint64_t seen = 0;
+
+        for (size_t idx = 0; idx < kBuckets; ++idx)
+        {
+            seen += counts[idx];
+
+            if (seen >= target)
+                return min(upper_of(idx), max_value);
+        }
+
+        return max_value;
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t max() const { return max_value; }
+};
+
+/* push_back 하나하나의 시간을 기록하고, 전체 시간을 돌려준다. */
+template <typename Container>
+double record_push_back(int n, LogHistogram& hist)
+{
+    Container v;
+
+    steady_clock::time_point begin = steady_clock::now();
+
+    for (int i = 0; i < n; ++i)
+    {
+        steady_clock::time_point start = steady_clock::now();
+        v.push_back(WidgetImpl(i));
+        steady_clock::time_point end = steady_clock::now();
+
+        hist.record(static_cast<uint64_t>(duration_cast<nanoseconds>(end - start).count()));
+    }
+
+    return duration<double>(steady_clock::now() - begin).count();
+}
+
+void print(const char* label, double seconds, const LogHistogram& h)
+{
+    cout << label << ": " << seconds << " 초"
+         << ", p50 " << h.percentile(0.5) << " ns"
+         << ", p99 " << h.percentile(0.99) << " ns"
+         << ", p99.9 " << h.percentile(0.999) << " ns"
+         << ", max " << h.max() << " ns" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+
+    /* 옮기는 도중에도 인덱싱은 올바른 원소를 가리킨다. */
+    {
+        IncrementalVector<WidgetImpl> iv;
+
+        for (int i = 0; i < 1000; ++i)
+            iv.push_back(WidgetImpl(i));
+
+        bool ok = true;
+
+        for (int i = 0; i < 1000; ++i)
+            ok = ok && iv[i].id() == i;
+
+        cout << "인덱싱 확인: " << boolalpha << ok << endl;
+    }
+
+    unique_ptr<LogHistogram> vw_hist = make_unique<LogHistogram>();
+    unique_ptr<LogHistogram> iv_hist = make_unique<LogHistogram>();
+
+    /* 재할당하는 push_back 하나가 모든 원소를 옮기는 버전 */
+    double vw_time = record_push_back<vector<WidgetImpl>>(n, *vw_hist);
+
+    /* 재할당 비용을 이후 push_back 들에 나눠 내는 버전 */
+    double iv_time = record_push_back<IncrementalVector<WidgetImpl>>(n, *iv_hist);
+
+    print("vw", vw_time, *vw_hist);
+    print("IncrementalVector", iv_time, *iv_hist);
+
+    return 0;
+}
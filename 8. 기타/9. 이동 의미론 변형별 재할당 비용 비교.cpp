@@ -0,0 +1,355 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+
+using namespace std;
+using namespace std::chrono;
+
+/*
+ * 이동 의미론 변형별 재할당 비용 비교
+ *
+ * 주석으로만 남아 있던 주장을 같은 벤치마크로 확인한다.
+ *
+ * WidgetImpl<M>
+ * - CopyOnly:   복사 생성자만 선언 (이동 생성자가 암시적으로 만들어지지 않는다.)
+ * - Throwing:   이동 생성자가 noexcept 이 아님 → 재할당 시에 복사
+ * - Noexcept:   noexcept 이동 생성자 → 재할당 시에 이동
+ * - RuleOfZero: 특수 멤버 함수를 선언하지 않음 → 컴파일러가 noexcept 이동을 만든다.
+ *
+ * Widget<NoexceptMove>
+ * - Pimpl 은 복사 생성자가 없으므로(unique_ptr)
+ *   이동 생성자가 noexcept 이 아니더라도 vector 는 어쩔 수 없이 이동을 사용한다.
+ *   (move_if_noexcept 는 복사할 수 없는 타입이면 이동한다.)
+ *   그래서 Pimpl 과 Pimpl noexcept 는 같은 결과가 나와야 한다.
+ *
+ * 각 변형마다 시간(중앙값), 힙 할당 횟수/바이트, 최대 힙 증가량, 최대 RSS 증가량을 표로 출력한다.
+ * - RSS 는 해제된 메모리를 할당자가 쥐고 있으면 줄지 않으므로 힙 수치가 더 정확하다.
+ */
+
+/*
+ * 전역 operator new/delete 교체로 힙 할당 추적 (1. 과 같은 방식)
+ *
+ * 표에 할당 수치가 들어가므로 TRACK_ALLOC 없이도 항상 켜져 있다.
+ * - 해제 시 크기를 알아야 하므로 블록 앞에 크기를 기록해 둔다.
+ * - 벤치마크는 단일 스레드이므로 카운터는 atomic 이 아니다.
+ */
+struct AllocStats
+{
+    size_t allocs = 0, frees = 0, bytes = 0, live = 0, peak = 0;
+};
+
+AllocStats g_alloc;
+
+constexpr size_t kAllocHeader = alignof(max_align_t);
+
+void* operator new(size_t size)
+{
+    char* raw = static_cast<char*>(malloc(size + kAllocHeader));
+
+    if (raw == nullptr)
+        throw bad_alloc();
+
+    *reinterpret_cast<size_t*>(raw) = size;
+
+    ++g_alloc.allocs;
+    g_alloc.bytes += size;
+    g_alloc.live += size;
+    g_alloc.peak = max(g_alloc.peak, g_alloc.live);
+
+    return raw + kAllocHeader;
+}
+
+/* 인라인되면 GCC 가 operator new 의 결과를 free 하는 것으로 보고
+ * -Wmismatched-new-delete 를 내므로 인라인하지 않는다. */
+__attribute__((noinline)) void operator delete(void* p) noexcept
+{
+    if (p == nullptr)
+        return;
+
+    char* raw = static_cast<char*>(p) - kAllocHeader;
+
+    ++g_alloc.frees;
+    g_alloc.live -= *reinterpret_cast<size_t*>(raw);
+
+    free(raw);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    operator delete(p);
+}
+
+/* 구간 시작: 누적 카운터를 비우고, 지금 살아 있는 바이트를 기준점으로 삼는다. */
+size_t alloc_phase_begin()
+{
+    g_alloc.allocs = g_alloc.frees = g_alloc.bytes = 0;
+    g_alloc.peak = g_alloc.live;
+
+    return g_alloc.live;
+}
+
+/* 구간 끝: live, peak 는 기준점 대비 증가량으로 돌려준다. */
+AllocStats alloc_phase_end(size_t base)
+{
+    AllocStats s = g_alloc;
+    s.live -= base;
+    s.peak -= base;
+
+    return s;
+}
+
+/*
+ * 최대 RSS (리눅스)
+ *
+ * /proc/self/clear_refs 에 5 를 쓰면 VmHWM(최대 RSS)이 현재 RSS 로 초기화된다.
+ */
+long read_status_kb(const char* key)
+{
+    ifstream status("/proc/self/status");
+    string word;
+
+    while (status >> word)
+    {
+        if (word == key)
+        {
+            long kb = 0;
+            status >> kb;
+            return kb;
+        }
+    }
+
+    return -1;
+}
+
+bool reset_peak_rss()
+{
+    ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+
+    return static_cast<bool>(clear_refs);
+}
+
+enum class Move { CopyOnly, Throwing, Noexcept, RuleOfZero };
+
+struct WidgetFields
+{
+    int i;
+    double b, c, d;
+    string name;
+    double arr[10];
+
+    WidgetFields(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : i(i), b(b), c(c), d(d), name(name)
+    {
+
+    }
+};
+
+/* RuleOfZero: 특수 멤버 함수를 선언하지 않는다. */
+template <Move M>
+class WidgetImpl : public WidgetFields
+{
+public:
+    using WidgetFields::WidgetFields;
+};
+
+template <>
+class WidgetImpl<Move::CopyOnly> : public WidgetFields
+{
+public:
+    using WidgetFields::WidgetFields;
+
+    WidgetImpl(const WidgetImpl& rhs) : WidgetFields(rhs) { }
+};
+
+template <>
+class WidgetImpl<Move::Throwing> : public WidgetFields
+{
+public:
+    using WidgetFields::WidgetFields;
+
+    WidgetImpl(const WidgetImpl& rhs) : WidgetFields(rhs) { }
+
+    WidgetImpl(WidgetImpl&& rhs) : WidgetFields(move(rhs)) { }
+};
+
+template <>
+class WidgetImpl<Move::Noexcept> : public WidgetFields
+{
+public:
+    using WidgetFields::WidgetFields;
+
+    WidgetImpl(const WidgetImpl& rhs) : WidgetFields(rhs) { }
+
+    WidgetImpl(WidgetImpl&& rhs) noexcept : WidgetFields(move(rhs)) { }
+};
+
+template <bool NoexceptMove>
+class Widget
+{
+    unique_ptr<WidgetImpl<Move::RuleOfZero>> pimpl;
+
+public:
+    Widget(int i = 0, double b = 0.0, double c = 0.0, double d = 0.0, string name = "AAAAAAAAAAAAAABBBBBBBBBBB")
+    : pimpl(make_unique<WidgetImpl<Move::RuleOfZero>>(i, b, c, d, name))
+    {
+
+    }
+
+    Widget(Widget&& rhs) noexcept(NoexceptMove) : pimpl(move(rhs.pimpl))
+    {
+
+    }
+};
+
+/*
+ * 벤치마크 하네스 (1. 과 같은 구현)
+ *
+ * - 워밍업 실행은 버리고, reps 번 반복 측정한다.
+ * - 중앙값/p95/MAD 로 요약한다. (튀는 값에 강하다.)
+ */
+struct Stats
+{
+    double median, p95, mad, min, max;
+};
+
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    /* 선형 보간 */
+    double pos = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+Stats summarize(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+
+    Stats s{};
+    s.median = percentile(samples, 0.5);
+    s.p95 = percentile(samples, 0.95);
+    s.min = samples.empty() ? 0.0 : samples.front();
+    s.max = samples.empty() ? 0.0 : samples.back();
+
+    /* MAD: 중앙값으로부터의 절대 편차들의 중앙값 */
+    vector<double> dev;
+    for (double x : samples)
+        dev.push_back(fabs(x - s.median));
+    sort(dev.begin(), dev.end());
+    s.mad = percentile(dev, 0.5);
+
+    return s;
+}
+
+/* 측정할 구간만 body 안에서 재서 초 단위로 돌려준다.
+ * 컨테이너 소멸은 측정 구간 밖에서 일어나도록 body 가 책임진다. */
+template <typename Body>
+vector<double> run_bench(Body body, int warmup, int reps)
+{
+    for (int i = 0; i < warmup; ++i)
+        body();
+
+    vector<double> samples;
+    samples.reserve(reps);
+
+    for (int i = 0; i < reps; ++i)
+        samples.push_back(body());
+
+    return samples;
+}
+
+/* 1. 의 -w 기본값과 같다. */
+constexpr int kWarmup = 1;
+
+struct Row
+{
+    const char* name;
+    double seconds;
+    AllocStats alloc;   // 마지막 반복의 측정 구간
+    long peak_rss_kb;
+};
+
+template <typename T>
+Row run_variant(const char* name, int n, int reps)
+{
+    AllocStats alloc;
+    long peak_rss_kb = 0;
+
+    Stats stats = summarize(run_bench([&] {
+        bool peak_ok = reset_peak_rss();
+        long rss_before = read_status_kb("VmRSS:");
+        double seconds;
+
+        {
+            vector<T> v;
+
+            size_t base = alloc_phase_begin();
+            steady_clock::time_point start = steady_clock::now();
+
+            for (int i = 0; i < n; ++i)
+                v.push_back(T(i));
+
+            steady_clock::time_point end = steady_clock::now();
+
+            seconds = duration<double>(end - start).count();
+            alloc = alloc_phase_end(base);
+        }
+
+        peak_rss_kb = peak_ok ? read_status_kb("VmHWM:") - rss_before : -1;
+
+        return seconds;
+    }, kWarmup, reps));
+
+    return Row{name, stats.median, alloc, peak_rss_kb};
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 3000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 3;
+
+    if (reps < 1)
+    {
+        cerr << "반복 횟수는 1 이상이어야 한다." << endl;
+        return 1;
+    }
+
+    vector<Row> rows;
+    rows.push_back(run_variant<WidgetImpl<Move::CopyOnly>>("copy only", n, reps));
+    rows.push_back(run_variant<WidgetImpl<Move::Throwing>>("throwing move", n, reps));
+    rows.push_back(run_variant<WidgetImpl<Move::Noexcept>>("noexcept move", n, reps));
+    rows.push_back(run_variant<WidgetImpl<Move::RuleOfZero>>("rule of zero", n, reps));
+    rows.push_back(run_variant<Widget<false>>("pimpl", n, reps));
+    rows.push_back(run_variant<Widget<true>>("pimpl noexcept", n, reps));
+
+    cout << left << setw(16) << "variant" << right
+         << setw(12) << "seconds"
+         << setw(12) << "allocs"
+         << setw(16) << "bytes"
+         << setw(16) << "peak heap"
+         << setw(16) << "peak RSS KiB" << endl;
+
+    for (const Row& row : rows)
+        cout << left << setw(16) << row.name << right
+             << setw(12) << row.seconds
+             << setw(12) << row.alloc.allocs
+             << setw(16) << row.alloc.bytes
+             << setw(16) << row.alloc.peak
+             << setw(16) << row.peak_rss_kb << endl;
+
+    return 0;
+}